@@ -19,6 +19,12 @@ const inline QString pathName( const QString& baseName, const QString& suffix )
     return QFile( fileName ).exists() ? fileName : QString();
 }
 
+GraphicProvider::~GraphicProvider()
+{
+    // prefetch tasks must not call loadGraphic of a destroyed object
+    cancelPrefetch();
+}
+
 const QskGraphic* GraphicProvider::loadGraphic( const QString& id ) const
 {
     static QString scope = QStringLiteral( ":/images/qvg/" );
@@ -9,6 +9,9 @@
 
 class GraphicProvider final : public QskGraphicProvider
 {
+  public:
+    ~GraphicProvider() override;
+
   protected:
     const QskGraphic* loadGraphic( const QString& id ) const override;
 };
@@ -17,6 +17,7 @@
 #include <QskPushButton.h>
 #include <QskScrollArea.h>
 #include <QskQuick.h>
+#include <QskVirtualGridBox.h>
 #include <QskWindow.h>
 
 #include <QGuiApplication>
@@ -24,9 +25,7 @@
 
 #include <cstdlib>
 
-#define HIDE_NODES 1
-
-const int gridSize = 20;
+const int gridSize = 100;
 const int thumbnailSize = 150;
 
 static QColor randomColor()
@@ -67,15 +66,17 @@ static int randomShape()
 class Thumbnail : public QskPushButton
 {
   public:
-    Thumbnail( const QColor& color, int shape, QQuickItem* parentItem )
+    Thumbnail( QQuickItem* parentItem = nullptr )
         : QskPushButton( parentItem )
     {
-        const QSizeF size( thumbnailSize, thumbnailSize );
+        setFixedSize( thumbnailSize, thumbnailSize );
+        setSection( QskAspect::Header ); // to make them flat
+    }
 
+    void setThumbnail( const QColor& color, int shape )
+    {
+        const QSizeF size( thumbnailSize, thumbnailSize );
         setGraphic( thumbnailGraphic( color, shape, size ) );
-        setFixedSize( size );
-
-        setSection( QskAspect::Header ); // to make them flat
     }
 
   private:
@@ -103,81 +104,53 @@ class Thumbnail : public QskPushButton
     }
 };
 
-class IconGrid : public QskLinearBox
+class IconGrid : public QskVirtualGridBox
 {
   public:
     IconGrid( QQuickItem* parentItem = nullptr )
-        : QskLinearBox( Qt::Horizontal, gridSize, parentItem )
+        : QskVirtualGridBox( parentItem )
     {
         setMargins( 20 );
         setSpacing( 20 );
 
-        for ( int col = 0; col < gridSize; col++ )
+        setDimension( gridSize );
+        setCellSize( QSizeF( thumbnailSize, thumbnailSize ) );
+
+        // one extra row/column, so that flicking does not reveal empty cells
+        setOverscan( thumbnailSize );
+
+        const int count = gridSize * gridSize;
+
+        m_colors.reserve( count );
+        m_shapes.reserve( count );
+
+        for ( int i = 0; i < count; i++ )
         {
-            for ( int row = 0; row < gridSize; row++ )
-                ( void ) new Thumbnail( randomColor(), randomShape(), this );
+            m_colors += randomColor();
+            m_shapes += randomShape();
         }
 
-#if HIDE_NODES
         /*
             When having too many nodes, the scene graph becomes horribly slow.
-            So we explicitely hide all items outside the visible area
-            ( see updateVisibilities below ) and make use of the DeferredUpdate and
-            CleanupOnVisibility features of QskQuickItem.
+            So only the buttons for the visible cells are created and
+            buttons leaving the viewport are reused for the cells
+            becoming visible.
          */
-        setSize( sizeConstraint() );
-        updateLayout(); // so that every item has its initial geometry
-
-        for ( int i = 0; i < elementCount(); i++ )
-        {
-            if ( auto control = qskControlCast( itemAtIndex( i ) ) )
+        setDelegate(
+            []() { return new Thumbnail(); },
+            [this]( QQuickItem* item, int index )
             {
-                // to support the optimizations in ScrollArea::updateVisibilities
-                control->setPlacementPolicy( Qsk::Hidden, QskPlacementPolicy::Reserve );
-                control->setVisible( false );
+                static_cast< Thumbnail* >( item )->setThumbnail(
+                    m_colors[ index ], m_shapes[ index ] );
             }
-        }
-#endif
-    }
+        );
 
-#if HIDE_NODES
-    void updateVisibilities( const QRectF& viewPort )
-    {
-        if ( !isEmpty() && viewPort != m_viewPort )
-        {
-            setItemsVisible( m_viewPort, false );
-            setItemsVisible( viewPort, true );
-
-            m_viewPort = viewPort;
-        }
+        setCount( count );
     }
 
   private:
-    void setItemsVisible( const QRectF& rect, bool on )
-    {
-        const int dim = dimension();
-
-        // we know, that all items have the same size
-        const auto itemSize = itemAtIndex( 0 )->size();
-
-        const int rowMin = rect.top() / ( itemSize.height() + spacing() );
-        const int rowMax = rect.bottom() / ( itemSize.height() + spacing() );
-
-        const int colMin = rect.left() / ( itemSize.width() + spacing() );
-        const int colMax = rect.right() / ( itemSize.height() + spacing() );
-
-        for ( int row = rowMin; row <= rowMax; row++ )
-        {
-            for ( int col = colMin; col <= colMax; col++ )
-            {
-                if ( auto item = itemAtIndex( row * dim + col ) )
-                    item->setVisible( on );
-            }
-        }
-    }
-
-    QRectF m_viewPort;
-#endif
+    QVector< QColor > m_colors;
+    QVector< int > m_shapes;
 };
 
 class ScrollArea : public QskScrollArea
@@ -200,29 +173,6 @@ class ScrollArea : public QskScrollArea
         setBoxShapeHint( HorizontalScrollHandle, 8 );
 
         setFlickRecognizerTimeout( 300 );
-
-        connect( this, &QskScrollView::scrollPosChanged,
-            this, &ScrollArea::updateVisibilities );
-    }
-
-  protected:
-    void geometryChangeEvent( QskGeometryChangeEvent* event ) override
-    {
-        QskScrollArea::geometryChangeEvent( event );
-        updateVisibilities();
-    }
-
-  private:
-    void updateVisibilities()
-    {
-#if HIDE_NODES
-        const auto box = static_cast< IconGrid* >( scrolledItem() );
-        if ( box )
-        {
-            const QRectF viewPort( scrollPos(), viewContentsRect().size() );
-            box->updateVisibilities( viewPort );
-        }
-#endif
     }
 };
 
@@ -244,11 +194,9 @@ int main( int argc, char* argv[] )
         The thumbnails are implemented as buttons, so that we can see if the gesture
         recognition for the flicking works without stopping the buttons from being functional.
 
-        This example also shows, that blocking of the scene graph node creation
-        ( QskControl::DeferredUpdate + QskControl::CleanupOnVisibility )
-        could be improved to also respect being inside the window or a clip region.
-        To have a similar effect with what is possible today, the code
-        explicitely hide/show(s) the buttons out/inside the viewport.
+        The grid is a QskVirtualGridBox, that instantiates buttons
+        for the cells inside the viewport only. So the number of items
+        and scene graph nodes does not depend on the size of the grid.
 
         But here we only want to demonstrate how QskScrollArea works.
      */
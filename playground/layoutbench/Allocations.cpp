@@ -0,0 +1,60 @@
+/******************************************************************************
+ * QSkinny - Copyright (C) 2016 Uwe Rathmann
+ * This file may be used under the terms of the 3-clause BSD License
+ *****************************************************************************/
+
+#include "Allocations.h"
+
+#include <atomic>
+#include <cstdlib>
+
+static std::atomic< quint64 > qskAllocationCount( 0 );
+
+#if defined( __GLIBC__ )
+
+/*
+    Symbols of the executable take precedence over those of the
+    shared libraries, so that all calls of malloc end up here.
+    operator new is implemented on top of malloc.
+ */
+
+extern "C"
+{
+    void* __libc_malloc( size_t ) noexcept;
+    void* __libc_calloc( size_t, size_t ) noexcept;
+    void* __libc_realloc( void*, size_t ) noexcept;
+
+    void* malloc( size_t size ) noexcept
+    {
+        qskAllocationCount.fetch_add( 1, std::memory_order_relaxed );
+        return __libc_malloc( size );
+    }
+
+    void* calloc( size_t count, size_t size ) noexcept
+    {
+        qskAllocationCount.fetch_add( 1, std::memory_order_relaxed );
+        return __libc_calloc( count, size );
+    }
+
+    void* realloc( void* ptr, size_t size ) noexcept
+    {
+        qskAllocationCount.fetch_add( 1, std::memory_order_relaxed );
+        return __libc_realloc( ptr, size );
+    }
+}
+
+#endif
+
+bool Allocations::isSupported()
+{
+#if defined( __GLIBC__ )
+    return true;
+#else
+    return false;
+#endif
+}
+
+quint64 Allocations::count()
+{
+    return qskAllocationCount.load( std::memory_order_relaxed );
+}
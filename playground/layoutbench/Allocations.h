@@ -0,0 +1,19 @@
+/******************************************************************************
+ * QSkinny - Copyright (C) 2016 Uwe Rathmann
+ * This file may be used under the terms of the 3-clause BSD License
+ *****************************************************************************/
+
+#pragma once
+
+#include <QtGlobal>
+
+/*
+    Counting the heap allocations of the process - including the
+    ones from inside of the Qt libraries. This is done by replacing
+    malloc and friends, what is only implemented for glibc.
+ */
+namespace Allocations
+{
+    bool isSupported();
+    quint64 count();
+}
@@ -0,0 +1,258 @@
+/******************************************************************************
+ * QSkinny - Copyright (C) 2016 Uwe Rathmann
+ * This file may be used under the terms of the 3-clause BSD License
+ *****************************************************************************/
+
+#include "Tree.h"
+
+#include <QskGridBox.h>
+#include <QskLinearBox.h>
+#include <QskTextLabel.h>
+
+#include <QJsonObject>
+#include <QStringList>
+
+#include <cmath>
+
+namespace
+{
+    class Builder
+    {
+      public:
+        Builder( const TreeConfig& config )
+            : m_config( config )
+        {
+        }
+
+        QQuickItem* createBox( int level )
+        {
+            if ( m_config.grid )
+                return createGrid( level );
+
+            return createLinearBox( level );
+        }
+
+        int leafCount() const
+        {
+            return m_leafCount;
+        }
+
+      private:
+        // the parent is set, when adding the child to its box
+        QQuickItem* createChild( int level )
+        {
+            if ( level + 1 < m_config.depth )
+                return createBox( level + 1 );
+
+            return createLeaf();
+        }
+
+        QQuickItem* createLinearBox( int level )
+        {
+            // alternating orientations, like in most real life UIs
+            const auto orientation = ( level % 2 ) ? Qt::Horizontal : Qt::Vertical;
+
+            auto box = new QskLinearBox( orientation );
+
+            for ( int i = 0; i < m_config.fanOut; i++ )
+            {
+                auto child = createChild( level );
+                box->addItem( child );
+
+                if ( m_config.stretch )
+                    box->setStretchFactor( child, 1 + i % 2 );
+
+                if ( isSpacerPosition( i ) )
+                    box->addSpacer( 10 );
+            }
+
+            return box;
+        }
+
+        QQuickItem* createGrid( int level )
+        {
+            auto grid = new QskGridBox();
+
+            const int columns = qMax( 2,
+                static_cast< int >( std::ceil( std::sqrt( m_config.fanOut ) ) ) );
+
+            int row = 0;
+            int column = 0;
+
+            const auto advance = [&]( int span )
+            {
+                column += span;
+                if ( column >= columns )
+                {
+                    row++;
+                    column = 0;
+                }
+            };
+
+            for ( int i = 0; i < m_config.fanOut; i++ )
+            {
+                int span = 1;
+
+                if ( m_config.spanEvery > 0 && ( i + 1 ) % m_config.spanEvery == 0 )
+                {
+                    if ( column + 2 > columns )
+                        advance( columns - column ); // next row
+
+                    span = 2;
+                }
+
+                auto child = createChild( level );
+                grid->addItem( child, row, column, 1, span );
+
+                advance( span );
+
+                if ( isSpacerPosition( i ) )
+                {
+                    grid->addSpacer( QSizeF( 10, 10 ), row, column );
+                    advance( 1 );
+                }
+            }
+
+            if ( m_config.stretch )
+            {
+                for ( int c = 0; c < columns; c++ )
+                    grid->setColumnStretchFactor( c, 1 + c % 2 );
+            }
+
+            return grid;
+        }
+
+        QQuickItem* createLeaf()
+        {
+            const int index = m_leafCount++;
+
+            if ( m_config.heightForWidth )
+            {
+                static const char text[] =
+                    "The quick brown fox jumps over the lazy dog";
+
+                auto label = new QskTextLabel(
+                    QStringLiteral( "%1: %2" ).arg( index ).arg( text ) );
+
+                label->setWrapMode( QskTextOptions::WordWrap );
+                return label;
+            }
+
+            auto control = new QskControl();
+            control->setPreferredSize( 20 + index % 10, 20 );
+            control->setSizePolicy( QskSizePolicy::Expanding, QskSizePolicy::Preferred );
+
+            return control;
+        }
+
+        inline bool isSpacerPosition( int index ) const
+        {
+            return ( m_config.spacerEvery > 0 )
+                && ( index + 1 ) % m_config.spacerEvery == 0
+                && ( index + 1 ) < m_config.fanOut;
+        }
+
+        const TreeConfig& m_config;
+        int m_leafCount = 0;
+    };
+}
+
+static bool parseInt( const QString& value, int min, int& result )
+{
+    bool ok;
+    const int v = value.toInt( &ok );
+
+    if ( ok && v >= min )
+    {
+        result = v;
+        return true;
+    }
+
+    return false;
+}
+
+bool TreeConfig::parse( const QStringList& args, QString* error )
+{
+    for ( const auto& arg : args )
+    {
+        const auto pos = arg.indexOf( QLatin1Char( '=' ) );
+
+        const auto key = arg.left( pos );
+        const auto value = ( pos >= 0 ) ? arg.mid( pos + 1 ) : QString();
+
+        bool ok = true;
+
+        if ( key == QLatin1String( "--depth" ) )
+            ok = parseInt( value, 1, depth );
+        else if ( key == QLatin1String( "--fanout" ) )
+            ok = parseInt( value, 1, fanOut );
+        else if ( key == QLatin1String( "--spans" ) )
+            ok = parseInt( value, 0, spanEvery );
+        else if ( key == QLatin1String( "--spacers" ) )
+            ok = parseInt( value, 0, spacerEvery );
+        else if ( key == QLatin1String( "--grid" ) )
+            grid = true;
+        else if ( key == QLatin1String( "--stretch" ) )
+            stretch = true;
+        else if ( key == QLatin1String( "--hfw" ) )
+            heightForWidth = true;
+        else
+            ok = false;
+
+        if ( !ok )
+        {
+            if ( error )
+                *error = QStringLiteral( "Invalid option: %1" ).arg( arg );
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QString TreeConfig::name() const
+{
+    QString s = grid ? QStringLiteral( "Grid" ) : QStringLiteral( "Linear" );
+    s += QStringLiteral( "-d%1-f%2" ).arg( depth ).arg( fanOut );
+
+    if ( spanEvery > 0 )
+        s += QStringLiteral( "-span%1" ).arg( spanEvery );
+
+    if ( spacerEvery > 0 )
+        s += QStringLiteral( "-spacer%1" ).arg( spacerEvery );
+
+    if ( stretch )
+        s += QStringLiteral( "-stretch" );
+
+    if ( heightForWidth )
+        s += QStringLiteral( "-hfw" );
+
+    return s;
+}
+
+QJsonObject TreeConfig::toJson() const
+{
+    QJsonObject object;
+
+    object[ QStringLiteral( "depth" ) ] = depth;
+    object[ QStringLiteral( "fanOut" ) ] = fanOut;
+    object[ QStringLiteral( "grid" ) ] = grid;
+    object[ QStringLiteral( "spanEvery" ) ] = spanEvery;
+    object[ QStringLiteral( "stretch" ) ] = stretch;
+    object[ QStringLiteral( "heightForWidth" ) ] = heightForWidth;
+    object[ QStringLiteral( "spacerEvery" ) ] = spacerEvery;
+
+    return object;
+}
+
+QQuickItem* createTree( const TreeConfig& config, int* leafCount )
+{
+    Builder builder( config );
+    auto root = builder.createBox( 0 );
+
+    if ( leafCount )
+        *leafCount = builder.leafCount();
+
+    return root;
+}
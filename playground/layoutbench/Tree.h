@@ -0,0 +1,48 @@
+/******************************************************************************
+ * QSkinny - Copyright (C) 2016 Uwe Rathmann
+ * This file may be used under the terms of the 3-clause BSD License
+ *****************************************************************************/
+
+#pragma once
+
+#include <QString>
+
+class QQuickItem;
+class QJsonObject;
+class QStringList;
+
+/*
+    Parameters of a synthetic tree of layout boxes: boxes are nested
+    down to depth, where each box has fanOut children. The leaves are
+    controls with fixed preferred sizes or wrapping labels, that
+    introduce height-for-width dependencies.
+ */
+class TreeConfig
+{
+  public:
+    // parsing options like "--depth=3", fails for unknown options
+    bool parse( const QStringList& args, QString* error = nullptr );
+
+    QString name() const;
+    QJsonObject toJson() const;
+
+    int depth = 3;
+    int fanOut = 4;
+
+    // boxes of the inner levels are grids with fanOut items per row
+    bool grid = false;
+
+    // every n-th cell of a grid spans 2 columns, 0: no spans
+    int spanEvery = 0;
+
+    // alternating stretch factors for the children of the boxes
+    bool stretch = false;
+
+    // wrapping labels as leaves instead of controls with a fixed size
+    bool heightForWidth = false;
+
+    // a spacer after every n-th child of a box, 0: no spacers
+    int spacerEvery = 0;
+};
+
+QQuickItem* createTree( const TreeConfig&, int* leafCount = nullptr );
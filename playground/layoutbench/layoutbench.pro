@@ -0,0 +1,12 @@
+CONFIG += qskexample
+
+QT += quick_private
+
+HEADERS += \
+    Allocations.h \
+    Tree.h
+
+SOURCES += \
+    Allocations.cpp \
+    Tree.cpp \
+    main.cpp
@@ -0,0 +1,401 @@
+/******************************************************************************
+ * QSkinny - Copyright (C) 2016 Uwe Rathmann
+ * This file may be used under the terms of the 3-clause BSD License
+ *****************************************************************************/
+
+#include "Allocations.h"
+#include "Tree.h"
+
+#include <QskGridBox.h>
+#include <QskLayoutEngine2D.h>
+#include <QskLinearBox.h>
+#include <QskTextLabel.h>
+#include <QskWindow.h>
+
+#include <QGuiApplication>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+
+#include <cstdio>
+#include <functional>
+
+QSK_QT_PRIVATE_BEGIN
+#include <private/qquickwindow_p.h>
+QSK_QT_PRIVATE_END
+
+/*
+    Layout code usually runs from the polish phase of a window,
+    but for measuring it we don't want to have the costs of
+    rendering frames. So the items are put into a window, that is
+    never shown, and the polish phase is triggered manually.
+
+    The results are written to stdout as one JSON object per line,
+    so that they can be compared by scripts.
+
+    Options:
+
+        --iterations=N  number of resize steps per benchmark
+        --populate=N    number of items for the populate benchmarks, 0: none
+
+        --depth=N       nesting levels of the boxes
+        --fanout=N      children per box
+        --grid          grid boxes instead of linear boxes
+        --spans=N       every n-th cell of a grid spans 2 columns
+        --stretch       alternating stretch factors
+        --hfw           wrapping labels ( height-for-width ) as leaves
+        --spacers=N     a spacer after every n-th child
+
+    Without any tree option a predefined suite of trees is measured.
+ */
+
+static void polishItems( QQuickWindow* window )
+{
+    QQuickWindowPrivate::get( window )->polishItems();
+}
+
+static void printJson( const QJsonObject& object )
+{
+    const auto line = QJsonDocument( object ).toJson( QJsonDocument::Compact );
+
+    std::fputs( line.constData(), stdout );
+    std::fputc( '\n', stdout );
+    std::fflush( stdout );
+}
+
+static inline qreal sweepWidth( int i )
+{
+    // sweeping forth and back between a couple of widths
+    return 600 + 50 * ( i % 8 );
+}
+
+namespace
+{
+    /*
+        Accumulating time, allocations and cache statistics
+        of one phase over all iterations.
+     */
+    class Measurement
+    {
+      public:
+        void start()
+        {
+            m_allocations0 = Allocations::count();
+            readCounters( m_counters0 );
+
+            m_timer.start();
+        }
+
+        void stop()
+        {
+            m_nsecs += m_timer.nsecsElapsed();
+            m_allocations += Allocations::count() - m_allocations0;
+
+            quint64 counters[ QskLayoutStatistics::CounterCount ];
+            readCounters( counters );
+
+            for ( int i = 0; i < QskLayoutStatistics::CounterCount; i++ )
+                m_counters[ i ] += counters[ i ] - m_counters0[ i ];
+        }
+
+        QJsonObject toJson( int iterations ) const
+        {
+            namespace S = QskLayoutStatistics;
+
+            const auto ms = m_nsecs / 1e6;
+
+            QJsonObject object;
+
+            object[ QStringLiteral( "ms" ) ] = ms;
+            object[ QStringLiteral( "msPerIteration" ) ] = ms / iterations;
+
+            if ( Allocations::isSupported() )
+            {
+                object[ QStringLiteral( "allocations" ) ] = double( m_allocations );
+                object[ QStringLiteral( "allocationsPerIteration" ) ] =
+                    double( m_allocations ) / iterations;
+            }
+            else
+            {
+                object[ QStringLiteral( "allocations" ) ] = QJsonValue();
+            }
+
+            object[ QStringLiteral( "chainCache" ) ] =
+                cacheJson( m_counters[ S::ChainCacheHits ], m_counters[ S::ChainCacheMisses ] );
+
+            object[ QStringLiteral( "metricsCache" ) ] =
+                cacheJson( m_counters[ S::MetricsCacheHits ], m_counters[ S::MetricsCacheMisses ] );
+
+            return object;
+        }
+
+      private:
+        static void readCounters( quint64* counters )
+        {
+            for ( int i = 0; i < QskLayoutStatistics::CounterCount; i++ )
+            {
+                counters[ i ] = QskLayoutStatistics::value(
+                    static_cast< QskLayoutStatistics::Counter >( i ) );
+            }
+        }
+
+        static QJsonObject cacheJson( quint64 hits, quint64 misses )
+        {
+            const auto total = hits + misses;
+
+            QJsonObject object;
+
+            object[ QStringLiteral( "hits" ) ] = double( hits );
+            object[ QStringLiteral( "misses" ) ] = double( misses );
+            object[ QStringLiteral( "hitRate" ) ] =
+                total ? QJsonValue( double( hits ) / total ) : QJsonValue();
+
+            return object;
+        }
+
+        QElapsedTimer m_timer;
+
+        qint64 m_nsecs = 0;
+        quint64 m_allocations = 0;
+        quint64 m_counters[ QskLayoutStatistics::CounterCount ] = {};
+
+        quint64 m_allocations0 = 0;
+        quint64 m_counters0[ QskLayoutStatistics::CounterCount ] = {};
+    };
+}
+
+static void benchmarkResize( QskWindow* window,
+    const TreeConfig& config, int iterations )
+{
+    int leafCount = 0;
+
+    auto root = static_cast< QskControl* >( createTree( config, &leafCount ) );
+    root->setParentItem( window->contentItem() );
+
+    /*
+        Parent layouts ask for the preferred size - with a width
+        as constraint, when having height-for-width content -
+        before assigning a geometry.
+     */
+    const auto sizeHint = [&]( int i )
+    {
+        QSizeF constraint;
+        if ( config.heightForWidth )
+            constraint.setWidth( sweepWidth( i ) );
+
+        return root->effectiveSizeHint( Qt::PreferredSize, constraint );
+    };
+
+    // first layouts outside of the measurement
+    for ( int i = 0; i < 8; i++ )
+    {
+        sizeHint( i );
+
+        root->setSize( QSizeF( sweepWidth( i ), 600 ) );
+        polishItems( window );
+    }
+
+    Measurement hintMeasurement;
+    Measurement layoutMeasurement;
+
+    for ( int i = 0; i < iterations; i++ )
+    {
+        hintMeasurement.start();
+        sizeHint( i );
+        hintMeasurement.stop();
+
+        layoutMeasurement.start();
+        root->setSize( QSizeF( sweepWidth( i ), 600 ) );
+        polishItems( window );
+        layoutMeasurement.stop();
+    }
+
+    QJsonObject object;
+
+    object[ QStringLiteral( "benchmark" ) ] = QStringLiteral( "resize" );
+    object[ QStringLiteral( "name" ) ] = config.name();
+    object[ QStringLiteral( "config" ) ] = config.toJson();
+    object[ QStringLiteral( "leaves" ) ] = leafCount;
+    object[ QStringLiteral( "iterations" ) ] = iterations;
+    object[ QStringLiteral( "sizeHint" ) ] = hintMeasurement.toJson( iterations );
+    object[ QStringLiteral( "setGeometries" ) ] = layoutMeasurement.toJson( iterations );
+
+    printJson( object );
+
+    delete root;
+}
+
+static QVector< TreeConfig > suite()
+{
+    QVector< TreeConfig > configs;
+
+    TreeConfig config;
+
+    // wide and shallow, without height-for-width dependencies
+    config.depth = 2;
+    config.fanOut = 10;
+    configs += config;
+
+    // deep and narrow
+    config.depth = 6;
+    config.fanOut = 3;
+    configs += config;
+
+    config.stretch = true;
+    config.spacerEvery = 2;
+    configs += config;
+
+    // grids of wrapping labels
+    config = TreeConfig();
+    config.grid = true;
+    config.depth = 3;
+    config.fanOut = 9;
+    config.heightForWidth = true;
+    configs += config;
+
+    config.spanEvery = 4;
+    config.stretch = true;
+    configs += config;
+
+    // linear boxes of wrapping labels
+    config = TreeConfig();
+    config.depth = 4;
+    config.fanOut = 4;
+    config.heightForWidth = true;
+    configs += config;
+
+    return configs;
+}
+
+static QVector< QQuickItem* > labels( int count )
+{
+    QVector< QQuickItem* > items;
+    items.reserve( count );
+
+    for ( int i = 0; i < count; i++ )
+        items += new QskTextLabel( QString::number( i ) );
+
+    return items;
+}
+
+using PopulateFunction =
+    std::function< void( QQuickItem*, const QVector< QQuickItem* >& ) >;
+
+static void benchmarkPopulate( const char* name, QskWindow* window,
+    int count, const PopulateFunction& populate, QQuickItem* box )
+{
+    box->setParentItem( window->contentItem() );
+    box->setSize( QSizeF( 800, 600 ) );
+
+    const auto items = labels( count );
+
+    QElapsedTimer timer;
+    timer.start();
+
+    populate( box, items );
+    polishItems( window );
+
+    QJsonObject object;
+
+    object[ QStringLiteral( "benchmark" ) ] = QStringLiteral( "populate" );
+    object[ QStringLiteral( "name" ) ] = QLatin1String( name );
+    object[ QStringLiteral( "items" ) ] = count;
+    object[ QStringLiteral( "ms" ) ] = timer.nsecsElapsed() / 1e6;
+
+    printJson( object );
+
+    delete box;
+}
+
+static void benchmarkPopulate( QskWindow* window, int count )
+{
+    const int columns = 20;
+
+    benchmarkPopulate( "LinearBox::addItem", window, count,
+        []( QQuickItem* box, const QVector< QQuickItem* >& items )
+        {
+            for ( auto item : items )
+                static_cast< QskLinearBox* >( box )->addItem( item );
+        },
+        new QskLinearBox( Qt::Horizontal, columns ) );
+
+    benchmarkPopulate( "LinearBox::addItems", window, count,
+        []( QQuickItem* box, const QVector< QQuickItem* >& items )
+        {
+            static_cast< QskLinearBox* >( box )->addItems( items );
+        },
+        new QskLinearBox( Qt::Horizontal, columns ) );
+
+    benchmarkPopulate( "GridBox::addItem", window, count,
+        []( QQuickItem* box, const QVector< QQuickItem* >& items )
+        {
+            for ( int i = 0; i < items.count(); i++ )
+            {
+                static_cast< QskGridBox* >( box )->addItem(
+                    items[i], i / columns, i % columns );
+            }
+        },
+        new QskGridBox() );
+
+    benchmarkPopulate( "GridBox::addItems", window, count,
+        []( QQuickItem* box, const QVector< QQuickItem* >& items )
+        {
+            static_cast< QskGridBox* >( box )->addItems( items, 0, 0, columns );
+        },
+        new QskGridBox() );
+}
+
+int main( int argc, char* argv[] )
+{
+    if ( qEnvironmentVariableIsEmpty( "QT_QPA_PLATFORM" ) )
+        qputenv( "QT_QPA_PLATFORM", "offscreen" );
+
+    QGuiApplication app( argc, argv );
+
+    int iterations = 200;
+    int populateCount = 10000;
+
+    QStringList treeOptions;
+
+    const auto args = app.arguments().mid( 1 );
+    for ( const auto& arg : args )
+    {
+        if ( arg.startsWith( QLatin1String( "--iterations=" ) ) )
+            iterations = qMax( arg.section( QLatin1Char( '=' ), 1 ).toInt(), 1 );
+        else if ( arg.startsWith( QLatin1String( "--populate=" ) ) )
+            populateCount = qMax( arg.section( QLatin1Char( '=' ), 1 ).toInt(), 0 );
+        else
+            treeOptions += arg;
+    }
+
+    QVector< TreeConfig > configs;
+
+    if ( treeOptions.isEmpty() )
+    {
+        configs = suite();
+    }
+    else
+    {
+        TreeConfig config;
+
+        QString error;
+        if ( !config.parse( treeOptions, &error ) )
+        {
+            std::fprintf( stderr, "%s\n", qPrintable( error ) );
+            return 1;
+        }
+
+        configs += config;
+    }
+
+    QskWindow window;
+
+    for ( const auto& config : qAsConst( configs ) )
+        benchmarkResize( &window, config, iterations );
+
+    if ( populateCount > 0 )
+        benchmarkPopulate( &window, populateCount );
+
+    return 0;
+}
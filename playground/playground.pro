@@ -5,8 +5,10 @@ SUBDIRS += \
     dials \
     dialogbuttons \
     invoker \
+    layoutbench \
     inputpanel \
     images \
+    qvgbench \
     shadows \
     shapes
 
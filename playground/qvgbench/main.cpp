@@ -0,0 +1,179 @@
+/******************************************************************************
+ * QSkinny - Copyright (C) 2016 Uwe Rathmann
+ * This file may be used under the terms of the 3-clause BSD License
+ *****************************************************************************/
+
+#include <QskGraphic.h>
+#include <QskGraphicIO.h>
+
+#include <QGuiApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QTemporaryDir>
+
+#include <cstdio>
+
+/*
+    Comparing the load times of the QDataStream based qvg format
+    with the flat format, that is read from a memory mapped file.
+
+    The flat format defers decoding paths and images until they are
+    needed, so the time for loading and rendering the graphic once
+    is measured as well.
+
+        qvgbench [--iterations=N] [ file.qvg | directory ] ...
+
+    Files, that are in the flat format already, are skipped. Without
+    any files the samples of the qvgviewer example are used.
+    The results are written to stdout as one JSON object per line.
+ */
+
+static void printJson( const QJsonObject& object )
+{
+    const auto line = QJsonDocument( object ).toJson( QJsonDocument::Compact );
+
+    std::fputs( line.constData(), stdout );
+    std::fputc( '\n', stdout );
+    std::fflush( stdout );
+}
+
+static void renderGraphic( const QskGraphic& graphic )
+{
+    QImage image( 256, 256, QImage::Format_ARGB32_Premultiplied );
+    image.fill( Qt::transparent );
+
+    QPainter painter( &image );
+    graphic.render( &painter, QRectF( 0, 0, 256, 256 ), Qt::KeepAspectRatio );
+}
+
+static QJsonObject measure( const QString& fileName, int iterations )
+{
+    qint64 loadTime = 0;
+    qint64 renderTime = 0;
+
+    int commandCount = 0;
+
+    for ( int i = 0; i < iterations; i++ )
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        const auto graphic = QskGraphicIO::read( fileName );
+
+        loadTime += timer.nsecsElapsed();
+
+        renderGraphic( graphic );
+
+        renderTime += timer.nsecsElapsed();
+
+        commandCount = graphic.commands().count();
+    }
+
+    QJsonObject object;
+
+    object[ QStringLiteral( "bytes" ) ] = double( QFileInfo( fileName ).size() );
+    object[ QStringLiteral( "commands" ) ] = commandCount;
+    object[ QStringLiteral( "loadMs" ) ] = loadTime / 1e6 / iterations;
+    object[ QStringLiteral( "loadAndRenderMs" ) ] = renderTime / 1e6 / iterations;
+
+    return object;
+}
+
+static QStringList qvgFiles( const QStringList& paths )
+{
+    QStringList files;
+
+    for ( const auto& path : paths )
+    {
+        const QFileInfo info( path );
+
+        if ( info.isDir() )
+        {
+            const auto entries = QDir( path ).entryInfoList(
+                { QStringLiteral( "*.qvg" ) }, QDir::Files, QDir::Name );
+
+            for ( const auto& entry : entries )
+                files += entry.absoluteFilePath();
+        }
+        else
+        {
+            files += info.absoluteFilePath();
+        }
+    }
+
+    return files;
+}
+
+static bool isFlat( const QString& fileName )
+{
+    QFile file( fileName );
+    return file.open( QIODevice::ReadOnly ) && file.read( 4 ) == "QSKF";
+}
+
+int main( int argc, char* argv[] )
+{
+    if ( qEnvironmentVariableIsEmpty( "QT_QPA_PLATFORM" ) )
+        qputenv( "QT_QPA_PLATFORM", "offscreen" );
+
+    QGuiApplication app( argc, argv );
+
+    int iterations = 100;
+    QStringList paths;
+
+    const auto args = app.arguments().mid( 1 );
+    for ( const auto& arg : args )
+    {
+        if ( arg.startsWith( QLatin1String( "--iterations=" ) ) )
+            iterations = qMax( arg.section( QLatin1Char( '=' ), 1 ).toInt(), 1 );
+        else
+            paths += arg;
+    }
+
+    if ( paths.isEmpty() )
+        paths += QStringLiteral( QVG_SAMPLES_DIR );
+
+    QTemporaryDir tmpDir;
+    if ( !tmpDir.isValid() )
+    {
+        std::fprintf( stderr, "Can't create a temporary directory\n" );
+        return 1;
+    }
+
+    const auto files = qvgFiles( paths );
+
+    for ( const auto& fileName : files )
+    {
+        if ( isFlat( fileName ) )
+            continue;
+
+        // QskGraphicIO::write always creates the flat format
+        const auto flatFileName = tmpDir.filePath( QFileInfo( fileName ).fileName() );
+
+        if ( !QskGraphicIO::write( QskGraphicIO::read( fileName ), flatFileName ) )
+        {
+            std::fprintf( stderr, "Can't convert %s\n", qPrintable( fileName ) );
+            continue;
+        }
+
+        // first loads outside of the measurement: filling the file system caches
+        renderGraphic( QskGraphicIO::read( fileName ) );
+        renderGraphic( QskGraphicIO::read( flatFileName ) );
+
+        QJsonObject object;
+
+        object[ QStringLiteral( "file" ) ] = QFileInfo( fileName ).fileName();
+        object[ QStringLiteral( "iterations" ) ] = iterations;
+        object[ QStringLiteral( "stream" ) ] = measure( fileName, iterations );
+        object[ QStringLiteral( "flat" ) ] = measure( flatFileName, iterations );
+
+        printJson( object );
+    }
+
+    return 0;
+}
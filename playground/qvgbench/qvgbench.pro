@@ -0,0 +1,7 @@
+CONFIG += qskexample
+
+# the samples of the qvgviewer example are the default input
+DEFINES += QVG_SAMPLES_DIR=\\\"$$PWD/../../examples/qvgviewer/qvg\\\"
+
+SOURCES += \
+    main.cpp
@@ -635,7 +635,13 @@ QSizeF QskControl::implicitSizeHint(
     }
     else
     {
-        hint = d_func()->implicitSizeHint( whichHint, constraint );
+        Q_D( const QskControl );
+
+        if ( !d->cachedSizeHint( whichHint, constraint, hint ) )
+        {
+            hint = d->implicitSizeHint( whichHint, constraint );
+            d->cacheSizeHint( whichHint, constraint, hint );
+        }
     }
 
     return hint;
@@ -766,6 +772,9 @@ bool QskControl::event( QEvent* event )
         }
         case QEvent::LayoutRequest:
         {
+            // the hints of a child have changed
+            d_func()->invalidateSizeHintCache();
+
             if ( d_func()->autoLayoutChildren )
             {
                 resetImplicitSize();
@@ -951,6 +960,12 @@ QRectF QskControl::focusIndicatorClipRect() const
     return clipRect();
 }
 
+void QskControl::invalidateSizeHintCaches()
+{
+    d_func()->invalidateSizeHintCache();
+    Inherited::invalidateSizeHintCaches();
+}
+
 void QskControl::updateLayout()
 {
 }
@@ -203,6 +203,8 @@ class QSK_EXPORT QskControl : public QskQuickItem, public QskSkinnable
 
     void initSizePolicy( QskSizePolicy::Policy, QskSizePolicy::Policy );
 
+    void invalidateSizeHintCaches() override;
+
     // called from updatePolish
     virtual void updateResources();
     virtual void updateLayout();
@@ -149,8 +149,34 @@ void qskInheritSection( QskControl* control, QskAspect::Section section )
     custom controls in QML.
  */
 
+static quint64 qskCachedSizeHints = 0;
+
+// number of implicit hints, that did not need to be recalculated
+quint64 qskCachedSizeHintCount()
+{
+    return qskCachedSizeHints;
+}
+
+struct QskControlPrivate::SizeHintCache
+{
+    struct Entry
+    {
+        Qt::SizeHint which;
+        QSizeF constraint;
+        QSizeF hint;
+    };
+
+    enum { Capacity = 8 };
+
+    Entry entries[ Capacity ];
+
+    int count = 0;
+    int next = 0;
+};
+
 QskControlPrivate::QskControlPrivate()
     : explicitSizeHints( nullptr )
+    , sizeHintCache( nullptr )
     , sizePolicy( QskSizePolicy::Preferred, QskSizePolicy::Preferred )
     , visiblePlacementPolicy( 0 )
     , hiddenPlacementPolicy( 0 )
@@ -167,6 +193,7 @@ QskControlPrivate::QskControlPrivate()
 QskControlPrivate::~QskControlPrivate()
 {
     delete [] explicitSizeHints;
+    delete sizeHintCache;
 }
 
 void QskControlPrivate::layoutConstraintChanged()
@@ -286,6 +313,55 @@ QSizeF QskControlPrivate::implicitSizeHint(
     return QSizeF( w, h );
 }
 
+bool QskControlPrivate::cachedSizeHint(
+    Qt::SizeHint which, const QSizeF& constraint, QSizeF& hint ) const
+{
+    if ( sizeHintCache == nullptr )
+        return false;
+
+    for ( int i = 0; i < sizeHintCache->count; i++ )
+    {
+        const auto& entry = sizeHintCache->entries[ i ];
+
+        if ( entry.which == which && entry.constraint == constraint )
+        {
+            hint = entry.hint;
+            qskCachedSizeHints++;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void QskControlPrivate::cacheSizeHint( Qt::SizeHint which,
+    const QSizeF& constraint, const QSizeF& hint ) const
+{
+    if ( sizeHintCache == nullptr )
+        sizeHintCache = new SizeHintCache();
+
+    auto& cache = *sizeHintCache;
+
+    // when being full we replace the oldest entry
+    auto& entry = cache.entries[ cache.next ];
+
+    entry.which = which;
+    entry.constraint = constraint;
+    entry.hint = hint;
+
+    cache.next = ( cache.next + 1 ) % SizeHintCache::Capacity;
+
+    if ( cache.count < SizeHintCache::Capacity )
+        cache.count++;
+}
+
+void QskControlPrivate::invalidateSizeHintCache()
+{
+    if ( sizeHintCache )
+        sizeHintCache->count = sizeHintCache->next = 0;
+}
+
 void QskControlPrivate::setExplicitSizeHint(
     Qt::SizeHint whichHint, const QSizeF& size )
 {
@@ -33,6 +33,15 @@ class QskControlPrivate : public QskQuickItemPrivate
     QSizeF implicitSizeHint( Qt::SizeHint, const QSizeF& ) const;
     QSizeF implicitSizeHint() const override final;
 
+    /*
+        Implicit hints, that are not covered by the implicit size
+        of QQuickItem. Parent layouts usually ask several times for the
+        same hints during one layout pass.
+     */
+    bool cachedSizeHint( Qt::SizeHint, const QSizeF& constraint, QSizeF& ) const;
+    void cacheSizeHint( Qt::SizeHint, const QSizeF& constraint, const QSizeF& ) const;
+    void invalidateSizeHintCache();
+
     void implicitSizeChanged() override final;
     void layoutConstraintChanged() override final;
 
@@ -46,6 +55,9 @@ class QskControlPrivate : public QskQuickItemPrivate
 
     QSizeF* explicitSizeHints;
 
+    struct SizeHintCache;
+    mutable SizeHintCache* sizeHintCache;
+
     QLocale locale;
 
     QskSizePolicy sizePolicy;
@@ -24,6 +24,17 @@ static void qskRegisterEventTypes()
 
 Q_CONSTRUCTOR_FUNCTION( qskRegisterEventTypes )
 
+const QQuickItem* qskLayoutRequestItem( const QEvent* event )
+{
+    if ( event && event->type() == QEvent::LayoutRequest )
+    {
+        if ( auto layoutRequest = dynamic_cast< const QskLayoutRequestEvent* >( event ) )
+            return layoutRequest->item();
+    }
+
+    return nullptr;
+}
+
 int qskFocusChainIncrement( const QEvent* event )
 {
     if ( event && event->type() == QEvent::KeyPress )
@@ -125,6 +136,25 @@ bool qskIsStandardKeyInput( const QKeyEvent* event, QKeySequence::StandardKey ke
 #endif
 }
 
+// -- QskLayoutRequestEvent
+
+QskLayoutRequestEvent::QskLayoutRequestEvent( const QQuickItem* item )
+    : QEvent( QEvent::LayoutRequest )
+    , m_item( item )
+{
+}
+
+#if QT_VERSION >= QT_VERSION_CHECK( 6, 0, 0 )
+
+QskLayoutRequestEvent* QskLayoutRequestEvent::clone() const
+{
+    return new QskLayoutRequestEvent( *this );
+}
+
+#endif
+
+// -- QskEvent
+
 QskEvent::QskEvent( QskEvent::Type type )
     : QEvent( static_cast< QEvent::Type >( type ) )
 {
@@ -160,6 +160,32 @@ class QSK_EXPORT QskAnimatorEvent : public QskEvent
     State m_state;
 };
 
+/*
+    A LayoutRequest, that has been sent by a child item, when its layout
+    relevant properties have changed. Layouts can use the item to
+    update their caches partially.
+ */
+class QSK_EXPORT QskLayoutRequestEvent : public QEvent
+{
+  public:
+    QskLayoutRequestEvent( const QQuickItem* );
+
+    inline const QQuickItem* item() const { return m_item; }
+
+#if QT_VERSION >= QT_VERSION_CHECK( 6, 0, 0 )
+    QskLayoutRequestEvent* clone() const override;
+#endif
+
+  protected:
+    QSK_EVENT_DISABLE_COPY( QskLayoutRequestEvent )
+
+  private:
+    const QQuickItem* m_item;
+};
+
+// the item that has sent a LayoutRequest, or nullptr when being unknown
+QSK_EXPORT const QQuickItem* qskLayoutRequestItem( const QEvent* );
+
 QSK_EXPORT int qskFocusChainIncrement( const QEvent* );
 
 // some helper to work around Qt version incompatibilities
@@ -11,9 +11,37 @@
 #include "QskSetup.h"
 #include "QskSkin.h"
 
+#include <qcoreapplication.h>
+#include <qmutex.h>
+#include <qpointer.h>
+#include <qthreadpool.h>
+
+#include <memory>
+
 QSK_SUBCONTROL( QskGraphicLabel, Panel )
 QSK_SUBCONTROL( QskGraphicLabel, Graphic )
 
+namespace
+{
+    /*
+        Shared between a label and the jobs calling its loadSource()
+        in a worker thread. The label is detached, while holding
+        the mutex, so that a running loadSource() has been completed
+        and pending jobs find nothing to load.
+     */
+    class SourceLoader
+    {
+      public:
+        SourceLoader( QskGraphicLabel* label )
+            : label( label )
+        {
+        }
+
+        QMutex mutex;
+        QskGraphicLabel* label;
+    };
+}
+
 class QskGraphicLabel::PrivateData
 {
   public:
@@ -23,16 +51,45 @@ class QskGraphicLabel::PrivateData
         , mirror( false )
         , isSourceDirty( !sourceUrl.isEmpty() )
         , hasPanel( false )
+        , asynchronous( false )
+        , isLoading( false )
+        , status( QskGraphicLabel::Null )
     {
     }
 
+    inline void invalidateSource()
+    {
+        isSourceDirty = true;
+
+        // outdating pending requests
+        isLoading = false;
+        loadId++;
+    }
+
+    void detachLoader()
+    {
+        if ( loader )
+        {
+            QMutexLocker locker( &loader->mutex );
+            loader->label = nullptr;
+        }
+
+        loader.reset();
+    }
+
     QUrl source;
     QskGraphic graphic;
 
+    std::shared_ptr< SourceLoader > loader;
+    uint loadId = 0;
+
     uint fillMode : 2;
     bool mirror : 1;
     bool isSourceDirty : 1;
     bool hasPanel : 1;
+    bool asynchronous : 1;
+    bool isLoading : 1;
+    uint status : 2;
 };
 
 QskGraphicLabel::QskGraphicLabel( const QUrl& source, QQuickItem* parent )
@@ -59,10 +116,14 @@ QskGraphicLabel::QskGraphicLabel( const QskGraphic& graphic, QQuickItem* parent
     : QskGraphicLabel( parent )
 {
     m_data->graphic = graphic;
+
+    if ( !graphic.isNull() )
+        m_data->status = Ready;
 }
 
 QskGraphicLabel::~QskGraphicLabel()
 {
+    m_data->detachLoader();
 }
 
 void QskGraphicLabel::setPanel( bool on )
@@ -104,7 +165,7 @@ void QskGraphicLabel::setSource( const QUrl& url )
         return;
 
     m_data->graphic.reset();
-    m_data->isSourceDirty = true;
+    m_data->invalidateSource();
     m_data->source = url;
 
     resetImplicitSize();
@@ -112,6 +173,50 @@ void QskGraphicLabel::setSource( const QUrl& url )
     update();
 
     Q_EMIT sourceChanged();
+
+    if ( url.isEmpty() )
+        setStatus( Null );
+}
+
+void QskGraphicLabel::setAsynchronous( bool on )
+{
+    if ( on != m_data->asynchronous )
+    {
+        m_data->asynchronous = on;
+
+        if ( !on )
+        {
+            // waiting for a loadSource() running in a worker thread
+            m_data->detachLoader();
+
+            if ( m_data->isLoading )
+            {
+                m_data->invalidateSource();
+                polish();
+            }
+        }
+
+        Q_EMIT asynchronousChanged( on );
+    }
+}
+
+bool QskGraphicLabel::asynchronous() const
+{
+    return m_data->asynchronous;
+}
+
+QskGraphicLabel::Status QskGraphicLabel::status() const
+{
+    return static_cast< Status >( m_data->status );
+}
+
+void QskGraphicLabel::setStatus( Status status )
+{
+    if ( status != m_data->status )
+    {
+        m_data->status = status;
+        Q_EMIT statusChanged( status );
+    }
 }
 
 QskGraphic QskGraphicLabel::graphic() const
@@ -135,6 +240,7 @@ void QskGraphicLabel::setGraphic( const QskGraphic& graphic )
     }
 
     // in case we have a sequence setting a source and a graphic later
+    m_data->invalidateSource();
     m_data->isSourceDirty = false;
 
     if ( !m_data->source.isEmpty() )
@@ -142,6 +248,8 @@ void QskGraphicLabel::setGraphic( const QskGraphic& graphic )
         m_data->source.clear();
         Q_EMIT sourceChanged();
     }
+
+    setStatus( graphic.isNull() ? Null : Ready );
 }
 
 void QskGraphicLabel::setGraphicRole( int role )
@@ -253,10 +361,82 @@ QskGraphic QskGraphicLabel::loadSource( const QUrl& url ) const
 
 void QskGraphicLabel::updateResources()
 {
-    if ( !m_data->source.isEmpty() && m_data->isSourceDirty )
-        m_data->graphic = loadSource( m_data->source );
+    loadGraphic();
+}
+
+void QskGraphicLabel::loadGraphic()
+{
+    if ( !m_data->isSourceDirty || m_data->isLoading )
+        return;
+
+    if ( m_data->source.isEmpty() )
+    {
+        m_data->isSourceDirty = false;
+        return;
+    }
+
+    if ( m_data->asynchronous )
+    {
+        if ( m_data->loader == nullptr )
+            m_data->loader = std::make_shared< SourceLoader >( this );
 
+        const auto loader = m_data->loader;
+        const auto source = m_data->source;
+        const auto loadId = m_data->loadId;
+
+        const QPointer< QskGraphicLabel > guard( this );
+
+        QThreadPool::globalInstance()->start(
+            [ loader, source, loadId, guard ]()
+            {
+                QskGraphic graphic;
+
+                {
+                    QMutexLocker locker( &loader->mutex );
+                    if ( loader->label == nullptr )
+                        return;
+
+                    graphic = loader->label->loadSource( source );
+                }
+
+                /*
+                    Posting to the label is not possible, as it might have
+                    been deleted in between. So we post to the application
+                    and check the guard, when being back in the GUI thread.
+                 */
+                QMetaObject::invokeMethod( QCoreApplication::instance(),
+                    [ guard, loadId, graphic ]()
+                    {
+                        if ( guard == nullptr )
+                            return;
+
+                        auto d = guard->m_data.get();
+
+                        if ( loadId != d->loadId || !d->isLoading )
+                            return; // the source has been changed in between
+
+                        d->graphic = graphic;
+                        d->isSourceDirty = false;
+                        d->isLoading = false;
+
+                        guard->resetImplicitSize();
+                        guard->update();
+
+                        guard->setStatus( graphic.isNull() ? Error : Ready );
+                    },
+                    Qt::QueuedConnection );
+            } );
+
+        m_data->isLoading = true;
+        setStatus( Loading );
+
+        return;
+    }
+
+    m_data->graphic = loadSource( m_data->source );
     m_data->isSourceDirty = false;
+
+    setStatus( m_data->graphic.isNull() ? Error : Ready );
 }
 
 QSizeF QskGraphicLabel::effectiveSourceSize() const
@@ -269,11 +449,13 @@ QSizeF QskGraphicLabel::effectiveSourceSize() const
         return strutSize;
     }
 
-    if ( !m_data->source.isEmpty() && m_data->isSourceDirty )
+    if ( m_data->isSourceDirty )
     {
-        // we have to load to know about the geometry
-        m_data->graphic = loadSource( m_data->source );
-        m_data->isSourceDirty = false;
+        /*
+            We have to load to know about the geometry. In asynchronous
+            mode the implicit size will be reset, when the graphic arrives.
+         */
+        const_cast< QskGraphicLabel* >( this )->loadGraphic();
     }
 
     QSizeF sz( 0, 0 );
@@ -312,7 +494,7 @@ void QskGraphicLabel::changeEvent( QEvent* event )
         if ( !m_data->source.isEmpty() && qskSetup->skin()->hasGraphicProvider() )
         {
             // we might need to reload from a different skin
-            m_data->isSourceDirty = true;
+            m_data->invalidateSource();
         }
     }
 
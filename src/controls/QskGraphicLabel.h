@@ -17,6 +17,11 @@ class QSK_EXPORT QskGraphicLabel : public QskControl
 
     Q_PROPERTY( QUrl source READ source WRITE setSource NOTIFY sourceChanged )
 
+    Q_PROPERTY( bool asynchronous READ asynchronous
+        WRITE setAsynchronous NOTIFY asynchronousChanged )
+
+    Q_PROPERTY( Status status READ status NOTIFY statusChanged )
+
     Q_PROPERTY( bool mirror READ mirror WRITE setMirror NOTIFY mirrorChanged )
 
     Q_PROPERTY( QSizeF graphicStrutSize READ graphicStrutSize
@@ -50,6 +55,16 @@ class QSK_EXPORT QskGraphicLabel : public QskControl
 
     Q_ENUM( FillMode )
 
+    enum Status
+    {
+        Null,
+        Ready,
+        Loading,
+        Error
+    };
+
+    Q_ENUM( Status )
+
     QskGraphicLabel( QQuickItem* parent = nullptr );
 
     QskGraphicLabel( const QUrl& url, QQuickItem* parent = nullptr );
@@ -67,6 +82,21 @@ class QSK_EXPORT QskGraphicLabel : public QskControl
     void setSource( const QString& source );
     void setSource( const QUrl& url );
 
+    /*
+        In asynchronous mode loadSource() is called from a worker thread.
+        Until the graphic has arrived the label is empty and its implicit
+        size is derived from the graphicStrutSize only.
+
+        Disabling asynchronous mode waits for a running loadSource().
+        So the destructor of a derived class, that overrides loadSource(),
+        has to call setAsynchronous( false ): when the destructor of
+        QskGraphicLabel is running, loadSource can't be called anymore.
+     */
+    void setAsynchronous( bool );
+    bool asynchronous() const;
+
+    Status status() const;
+
     void setGraphicStrutSize( const QSizeF& size );
     QSizeF graphicStrutSize() const;
     void resetGraphicStrutSize();
@@ -94,6 +124,8 @@ class QSK_EXPORT QskGraphicLabel : public QskControl
 
   Q_SIGNALS:
     void sourceChanged();
+    void asynchronousChanged( bool );
+    void statusChanged( Status );
     void mirrorChanged();
     void graphicStrutSizeChanged();
     void graphicRoleChanged( int );
@@ -110,6 +142,9 @@ class QSK_EXPORT QskGraphicLabel : public QskControl
     virtual QskGraphic loadSource( const QUrl& ) const;
 
   private:
+    void loadGraphic();
+    void setStatus( Status );
+
     class PrivateData;
     std::unique_ptr< PrivateData > m_data;
 };
@@ -12,6 +12,7 @@
 #include "QskSetup.h"
 #include "QskSkin.h"
 #include "QskSkinlet.h"
+#include "QskSubcontrolLayoutEngine.h"
 #include "QskTextOptions.h"
 
 #include <qfontmetrics.h>
@@ -47,6 +48,9 @@ class QskPushButton::PrivateData
     QUrl graphicSource;
     QskGraphic graphic;
 
+    // implicit sizes of text and graphic
+    QskSubcontrolHintCache hintCache;
+
     bool isCheckable : 1;
     bool isGraphicSourceDirty : 1;
 };
@@ -227,6 +231,17 @@ void QskPushButton::updateResources()
     m_data->ensureGraphic( this );
 }
 
+void QskPushButton::invalidateSizeHintCaches()
+{
+    m_data->hintCache.invalidate();
+    Inherited::invalidateSizeHintCaches();
+}
+
+QskSubcontrolHintCache* QskPushButton::hintCache() const
+{
+    return &m_data->hintCache;
+}
+
 QskAspect::Placement QskPushButton::effectivePlacement() const
 {
     if ( hasGraphic() && !text().isEmpty() )
@@ -11,6 +11,7 @@
 class QskBoxShapeMetrics;
 class QskGraphic;
 class QskTextOptions;
+class QskSubcontrolHintCache;
 
 class QSK_EXPORT QskPushButton : public QskAbstractButton
 {
@@ -97,9 +98,14 @@ class QSK_EXPORT QskPushButton : public QskAbstractButton
     void mousePressEvent( QMouseEvent* ) override;
 
     void updateResources() override;
+    void invalidateSizeHintCaches() override;
+
     virtual QskGraphic loadGraphic( const QUrl& ) const;
 
   private:
+    friend class QskPushButtonSkinlet;
+    QskSubcontrolHintCache* hintCache() const;
+
     class PrivateData;
     std::unique_ptr< PrivateData > m_data;
 };
@@ -29,11 +29,14 @@ namespace
     class LayoutEngine : public QskSubcontrolLayoutEngine
     {
       public:
-        LayoutEngine( const QskPushButton* button )
+        LayoutEngine( const QskPushButton* button, QskSubcontrolHintCache* hintCache )
             : QskSubcontrolLayoutEngine( qskOrientation( button ) )
         {
             setSpacing( button->spacingHint( QskPushButton::Panel ) );
 
+            // avoiding to measure the text again for each layout
+            setHintCache( hintCache );
+
             setGraphicTextElements( button,
                 QskPushButton::Text, button->text(),
                 QskPushButton::Graphic, button->graphic().defaultSize() );
@@ -60,7 +63,7 @@ QRectF QskPushButtonSkinlet::subControlRect( const QskSkinnable* skinnable,
     {
         const auto r = button->subControlContentsRect( contentsRect, Q::Panel );
 
-        LayoutEngine layoutEngine( button );
+        LayoutEngine layoutEngine( button, button->hintCache() );
         layoutEngine.setGeometries( r );
 
         return layoutEngine.subControlRect( subControl );
@@ -189,7 +192,7 @@ QSizeF QskPushButtonSkinlet::sizeHint( const QskSkinnable* skinnable,
 
     const auto button = static_cast< const QskPushButton* >( skinnable );
 
-    LayoutEngine layoutEngine( button );
+    LayoutEngine layoutEngine( button, button->hintCache() );
 
     auto size = layoutEngine.sizeHint( which, QSizeF() );
 
@@ -8,6 +8,7 @@
 #include "QskFunctions.h"
 #include "QskLayoutElement.h"
 #include <qquickitem.h>
+#include <qhash.h>
 
 QSK_QT_PRIVATE_BEGIN
 #include <private/qguiapplication_p.h>
@@ -356,6 +357,93 @@ QList< QQuickItem* > qskPaintOrderChildItems( const QQuickItem* item )
     return QList< QQuickItem* >();
 }
 
+void qskRestackChildItems( QQuickItem* parent, const QVector< QQuickItem* >& items )
+{
+    // all items have to be children of parent
+
+    if ( parent == nullptr || items.count() < 2 )
+        return;
+
+    /*
+        The order of the children is relevant for the tab focus chain.
+        When items are inserted in bulk they have usually been appended
+        in the right order already, what can be found out in one pass.
+     */
+
+    QHash< const QQuickItem*, int > ranks;
+    ranks.reserve( items.count() );
+
+    for ( int i = 0; i < items.count(); i++ )
+        ranks.insert( items[ i ], i );
+
+    bool isOrdered = true;
+
+    int lastRank = -1;
+
+    const auto& children = QQuickItemPrivate::get( parent )->childItems;
+    for ( const auto child : children )
+    {
+        const auto it = ranks.constFind( child );
+        if ( it != ranks.constEnd() )
+        {
+            if ( it.value() < lastRank )
+            {
+                isOrdered = false;
+                break;
+            }
+
+            lastRank = it.value();
+        }
+    }
+
+    if ( isOrdered )
+        return;
+
+    /*
+        Calling QQuickItem::stackAfter for each item would be linear
+        in the number of children each time. So we rebuild the list of
+        children in one pass: the items are moved behind the first one,
+        what has the same result as stacking them one after the other.
+     */
+
+    auto d = QQuickItemPrivate::get( parent );
+
+    QList< QQuickItem* > childItems;
+    childItems.reserve( d->childItems.count() );
+
+    for ( const auto child : qAsConst( d->childItems ) )
+    {
+        if ( child == items.first() )
+        {
+            for ( const auto item : items )
+                childItems += item;
+        }
+        else if ( !ranks.contains( child ) )
+        {
+            childItems += child;
+        }
+    }
+
+    int firstModified = 0;
+
+    while ( ( firstModified < childItems.count() )
+        && ( childItems[ firstModified ] == d->childItems[ firstModified ] ) )
+    {
+        firstModified++;
+    }
+
+    if ( firstModified == childItems.count() )
+        return;
+
+    d->childItems = childItems;
+
+    d->dirty( QQuickItemPrivate::ChildrenStackingChanged );
+    d->markSortedChildrenDirty( items.first() );
+
+    for ( int i = firstModified; i < childItems.count(); i++ )
+        QQuickItemPrivate::get( childItems[ i ] )->siblingOrderChanged();
+}
+
 const QSGNode* qskItemNode( const QQuickItem* item )
 {
     if ( item == nullptr )
@@ -11,6 +11,7 @@
 
 #include <qnamespace.h>
 #include <qquickitem.h>
+#include <qvector.h>
 
 class QskSizePolicy;
 
@@ -63,6 +64,9 @@ QSK_EXPORT void qskForceActiveFocus( QQuickItem*, Qt::FocusReason );
 
 QSK_EXPORT QList< QQuickItem* > qskPaintOrderChildItems( const QQuickItem* );
 
+// reordering children of the parent, so that the items are in the given order
+QSK_EXPORT void qskRestackChildItems( QQuickItem* parent, const QVector< QQuickItem* >& );
+
 QSK_EXPORT void qskUpdateInputMethod( const QQuickItem*, Qt::InputMethodQueries );
 QSK_EXPORT void qskInputMethodSetVisible( const QQuickItem*, bool );
 
@@ -553,6 +553,7 @@ void QskQuickItem::applyUpdateFlag( UpdateFlag flag, bool on )
 
             break;
         }
+        case QskQuickItem::MipmappedTextures:
         case QskQuickItem::DebugForceBackground:
         {
             // no need to mark it dirty
@@ -569,6 +570,8 @@ void QskQuickItem::resetImplicitSize()
 {
     Q_D( QskQuickItem );
 
+    invalidateSizeHintCaches();
+
     if ( d->updateFlags & QskQuickItem::DeferredLayout )
     {
         d->blockedImplicitSize = true;
@@ -926,6 +929,10 @@ void QskQuickItem::aboutToShow()
 {
 }
 
+void QskQuickItem::invalidateSizeHintCaches()
+{
+}
+
 void QskQuickItem::updateItemPolish()
 {
 }
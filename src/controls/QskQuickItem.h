@@ -43,6 +43,7 @@ class QSK_EXPORT QskQuickItem : public QQuickItem
         CleanupOnVisibility     =  1 << 3,
 
         PreferRasterForTextures =  1 << 4,
+        MipmappedTextures       =  1 << 5,
 
         DebugForceBackground    =  1 << 7
     };
@@ -147,6 +148,12 @@ class QSK_EXPORT QskQuickItem : public QQuickItem
 
     virtual void aboutToShow();  // called in updatePolish
 
+    /*
+        Called from resetImplicitSize(): controls, that cache
+        results of their size calculations, have to drop them.
+     */
+    virtual void invalidateSizeHintCaches();
+
   private:
     // don't use boundingRect - it seems to be deprecated
     QRectF boundingRect() const override final { return rect(); }
@@ -7,22 +7,32 @@
 #include "QskAspect.h"
 #include "QskFunctions.h"
 
+#include <qcoreapplication.h>
 #include <qfontmetrics.h>
+#include <qpointer.h>
+#include <qthreadpool.h>
 
-static inline qreal qskMaxWidth(
+#include <set>
+
+/*
+    Above this number of entries the widths are measured
+    in a worker thread, when setting all entries or when the
+    font has changed.
+ */
+static const int qskBackgroundMeasuringThreshold = 5000;
+
+static inline QVector< qreal > qskTextWidths(
     const QFont& font, const QStringList& list )
 {
     const QFontMetricsF fm( font );
 
-    qreal max = 0.0;
-    for ( int i = 0; i < list.size(); i++ )
-    {
-        const qreal w = qskHorizontalAdvance( fm, list[ i ] );
-        if ( w > max )
-            max = w;
-    }
+    QVector< qreal > widths;
+    widths.reserve( list.size() );
+
+    for ( const auto& text : list )
+        widths += qskHorizontalAdvance( fm, text );
 
-    return max;
+    return widths;
 }
 
 class QskSimpleListBox::PrivateData
@@ -34,11 +44,76 @@ class QskSimpleListBox::PrivateData
     {
     }
 
+    inline bool hasWidths() const
+    {
+        return !measuring && ( widths.size() == entries.size() );
+    }
+
+    void insertWidths( int index, const QVector< qreal >& newWidths )
+    {
+        for ( int i = 0; i < newWidths.size(); i++ )
+        {
+            widths.insert( index + i, newWidths[ i ] );
+            sortedWidths.insert( newWidths[ i ] );
+        }
+    }
+
+    void removeWidth( int index )
+    {
+        const auto it = sortedWidths.find( widths[ index ] );
+        if ( it != sortedWidths.end() )
+            sortedWidths.erase( it );
+
+        widths.remove( index );
+    }
+
+    void setWidths( const QVector< qreal >& newWidths )
+    {
+        widths = newWidths;
+        sortedWidths = std::multiset< qreal >( widths.constBegin(), widths.constEnd() );
+    }
+
+    void clearWidths()
+    {
+        widths.clear();
+        sortedWidths.clear();
+    }
+
+    void updateMaxTextWidth()
+    {
+        if ( columnWidthHint > 0.0 )
+            maxTextWidth = columnWidthHint;
+        else if ( sortedWidths.empty() )
+            maxTextWidth = 0.0;
+        else
+            maxTextWidth = *sortedWidths.crbegin();
+    }
+
     // one column at the moment only
     qreal maxTextWidth;
     qreal columnWidthHint;
 
     QStringList entries;
+
+    /*
+        The widths of the entries and the same values sorted, so that
+        we can find the maximum after inserting/removing entries
+        in O(log n). While being measured in the background the vector
+        of widths is empty.
+     */
+    QVector< qreal > widths;
+    std::multiset< qreal > sortedWidths;
+
+    // to identify outdated results from the worker thread
+    uint measureId = 0;
+
+    /*
+        Entries being modified, while the worker thread is running,
+        do not start another measurement. Instead the entries are
+        measured once more, when the pending result has arrived.
+     */
+    bool measuring = false;
+    bool measuringOutdated = false;
 };
 
 QskSimpleListBox::QskSimpleListBox( QQuickItem* parent )
@@ -77,11 +152,7 @@ void QskSimpleListBox::setColumnWidthHint( int column, qreal width )
     if ( width != m_data->columnWidthHint )
     {
         m_data->columnWidthHint = qMax( width, qreal( 0.0 ) );
-
-        if ( m_data->columnWidthHint > 0.0 )
-            m_data->maxTextWidth = m_data->columnWidthHint;
-        else
-            m_data->maxTextWidth = qskMaxWidth( effectiveFont( Text ), m_data->entries );
+        m_data->updateMaxTextWidth();
 
         updateScrollableSize();
     }
@@ -100,26 +171,36 @@ void QskSimpleListBox::insert( const QStringList& list, int index )
     if ( list.isEmpty() )
         return;
 
-    if ( m_data->columnWidthHint <= 0.0 )
-    {
-        const auto w = qskMaxWidth( effectiveFont( Text ), list );
-        if ( w > m_data->maxTextWidth )
-            m_data->maxTextWidth = w;
-    }
+    auto& entries = m_data->entries;
 
-    if ( m_data->entries.isEmpty() )
+    if ( index < 0 || index > entries.size() )
+        index = entries.size();
+
+    const bool hasWidths = m_data->hasWidths();
+
+    if ( entries.isEmpty() )
     {
-        m_data->entries = list;
+        entries = list;
     }
-    else if ( index < 0 || index >= m_data->entries.size() )
+    else if ( index == entries.size() )
     {
-        m_data->entries += list;
+        entries += list;
     }
     else
     {
         // is there no better way ???
         for ( int i = 0; i < list.size(); i++ )
-            m_data->entries.insert( index + i, list[ i ] );
+            entries.insert( index + i, list[ i ] );
+    }
+
+    if ( hasWidths && list.size() < qskBackgroundMeasuringThreshold )
+    {
+        m_data->insertWidths( index, qskTextWidths( effectiveFont( Text ), list ) );
+        m_data->updateMaxTextWidth();
+    }
+    else
+    {
+        measureEntries();
     }
 
     propagateEntries();
@@ -131,9 +212,7 @@ void QskSimpleListBox::setEntries( const QStringList& entries )
         return;
 
     m_data->entries.clear();
-
-    if ( m_data->columnWidthHint <= 0.0 )
-        m_data->maxTextWidth = 0.0;
+    m_data->clearWidths();
 
     insert( entries, -1 );
 }
@@ -145,19 +224,7 @@ QStringList QskSimpleListBox::entries() const
 
 void QskSimpleListBox::insert( const QString& text, int index )
 {
-    if ( m_data->columnWidthHint <= 0.0 )
-    {
-        const auto w = qskHorizontalAdvance( effectiveFont( Cell ), text );
-        if ( w > m_data->maxTextWidth )
-            m_data->maxTextWidth = w;
-    }
-
-    if ( index < 0 )
-        m_data->entries.append( text );
-    else
-        m_data->entries.insert( index, text );
-
-    propagateEntries();
+    insert( QStringList( text ), index );
 }
 
 void QskSimpleListBox::removeAt( int index )
@@ -167,16 +234,15 @@ void QskSimpleListBox::removeAt( int index )
     if ( index < 0 || index >= entries.size() )
         return;
 
-    if ( m_data->columnWidthHint <= 0.0 )
-    {
-        const auto w = qskHorizontalAdvance( effectiveFont( Cell ), entries[ index ] );
-        if ( w >= m_data->maxTextWidth )
-            m_data->maxTextWidth = qskMaxWidth( effectiveFont( Text ), entries );
-    }
+    if ( m_data->hasWidths() )
+        m_data->removeWidth( index );
+
+    entries.removeAt( index );
+
+    if ( m_data->hasWidths() )
+        m_data->updateMaxTextWidth();
     else
-    {
-        entries.removeAt( index );
-    }
+        measureEntries();
 
     propagateEntries();
 
@@ -203,11 +269,20 @@ void QskSimpleListBox::removeBulk( int from, int to )
     if ( to < from )
         return;
 
+    const bool hasWidths = m_data->hasWidths();
+
     for ( int i = to; i >= from; i-- )
+    {
+        if ( hasWidths )
+            m_data->removeWidth( i );
+
         m_data->entries.removeAt( i );
+    }
 
-    if ( m_data->columnWidthHint <= 0.0 )
-        m_data->maxTextWidth = qskMaxWidth( effectiveFont( Text ), m_data->entries );
+    if ( hasWidths )
+        m_data->updateMaxTextWidth();
+    else
+        measureEntries();
 
     propagateEntries();
 
@@ -245,14 +320,98 @@ void QskSimpleListBox::clear()
         return;
 
     m_data->entries.clear();
+    m_data->clearWidths();
+
+    // outdating running measurements
+    m_data->measureId++;
+    m_data->measuring = m_data->measuringOutdated = false;
 
-    if ( m_data->columnWidthHint <= 0.0 )
-        m_data->maxTextWidth = 0.0;
+    m_data->updateMaxTextWidth();
 
     propagateEntries();
     setSelectedRow( -1 );
 }
 
+void QskSimpleListBox::measureEntries()
+{
+    if ( m_data->measuring )
+    {
+        m_data->measuringOutdated = true;
+        return;
+    }
+
+    const auto measureId = ++m_data->measureId;
+
+    m_data->clearWidths();
+
+    const auto& entries = m_data->entries;
+    const auto font = effectiveFont( Text );
+
+    if ( entries.size() < qskBackgroundMeasuringThreshold )
+    {
+        m_data->setWidths( qskTextWidths( font, entries ) );
+        m_data->updateMaxTextWidth();
+
+        return;
+    }
+
+    /*
+        Measuring in a worker thread. Until the widths have arrived
+        the maximum width of the previous entries is kept.
+     */
+
+    m_data->measuring = true;
+    m_data->measuringOutdated = false;
+
+    const QPointer< QskSimpleListBox > guard( this );
+
+    QThreadPool::globalInstance()->start(
+        [ guard, measureId, font, entries ]()
+        {
+            const auto widths = qskTextWidths( font, entries );
+
+            QMetaObject::invokeMethod( QCoreApplication::instance(),
+                [ guard, measureId, widths ]()
+                {
+                    if ( guard && guard->m_data->measureId == measureId )
+                    {
+                        auto d = guard->m_data.get();
+                        d->measuring = false;
+
+                        if ( d->measuringOutdated )
+                        {
+                            // the entries have been modified in the meantime
+                            guard->measureEntries();
+                        }
+                        else
+                        {
+                            d->setWidths( widths );
+                            d->updateMaxTextWidth();
+                        }
+
+                        guard->updateScrollableSize();
+                        guard->update();
+                    }
+                },
+                Qt::QueuedConnection );
+        } );
+}
+
+void QskSimpleListBox::changeEvent( QEvent* event )
+{
+    if ( event->type() == QEvent::StyleChange )
+    {
+        // the font might have changed
+        if ( !m_data->entries.isEmpty() )
+        {
+            measureEntries();
+            updateScrollableSize();
+        }
+    }
+
+    Inherited::changeEvent( event );
+}
+
 void QskSimpleListBox::propagateEntries()
 {
 #if 1
@@ -57,8 +57,12 @@ class QSK_EXPORT QskSimpleListBox : public QskListView
     void entriesChanged();
     void selectedEntryChanged( const QString& );
 
+  protected:
+    void changeEvent( QEvent* ) override;
+
   private:
     void propagateEntries();
+    void measureEntries();
 
     class PrivateData;
     std::unique_ptr< PrivateData > m_data;
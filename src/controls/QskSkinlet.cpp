@@ -130,6 +130,7 @@ static inline QSGNode* qskUpdateGraphicNode(
     graphicNode->setRenderHint( useRaster ? QskPaintedNode::Raster : QskPaintedNode::OpenGL );
 
     graphicNode->setMirrored( mirrored );
+    graphicNode->setMipmapped( control->testUpdateFlag( QskControl::MipmappedTextures ) );
 
     const auto r = qskSceneAlignedRect( control, rect );
     graphicNode->setGraphic( control->window(), graphic, colorFilter, r );
@@ -166,8 +166,14 @@ static inline void qskTriggerUpdates( QskAspect aspect, QskControl* control )
             switch( aspect.flagPrimitive() )
             {
                 case A::GraphicRole:
+                {
+                    break;
+                }
                 case A::FontRole:
                 {
+                    // the size of texts depends on the font
+                    control->resetImplicitSize();
+                    maybeLayout = true;
                     break;
                 }
                 case A::Alignment:
@@ -13,17 +13,23 @@
 
 #include <qmath.h>
 #include <qpointer.h>
+#include <qrawfont.h>
+#include <qtimer.h>
 
 QSK_QT_PRIVATE_BEGIN
 #include <private/qquickitem_p.h>
 #include <private/qquickitemchangelistener_p.h>
 #include <private/qquickwindow_p.h>
+#include <private/qsgadaptationlayer_p.h>
+#include <private/qsgdefaultrendercontext_p.h>
 #include <private/qsgrenderer_p.h>
 QSK_QT_PRIVATE_END
 
 #include <qpa/qwindowsysteminterface.h>
 #include <QGuiApplication>
 
+#include <algorithm>
+
 // #define QSK_DEBUG_RENDER_TIMING
 
 #ifdef QSK_DEBUG_RENDER_TIMING
@@ -34,6 +40,17 @@ Q_LOGGING_CATEGORY( logTiming, "qsk.window.timing", QtCriticalMsg )
 
 #endif
 
+// #define QSK_DEBUG_SIZE_HINTS
+
+#ifdef QSK_DEBUG_SIZE_HINTS
+
+#include <qloggingcategory.h>
+Q_LOGGING_CATEGORY( logSizeHints, "qsk.window.sizehints", QtCriticalMsg )
+
+extern quint64 qskCachedSizeHintCount();
+
+#endif
+
 extern QLocale qskInheritedLocale( const QObject* );
 extern void qskInheritLocale( QObject*, const QLocale& );
 
@@ -132,6 +149,55 @@ static inline const QByteArray& qskVisualizationMode( const QQuickWindow* window
 #endif
 }
 
+static QString qskLocaleCharacters( const QLocale& locale )
+{
+    QString characters;
+
+    for ( ushort c = 0x20; c < 0x7f; c++ )
+        characters += QChar( c );
+
+    for ( int i = 0; i <= 9; i++ )
+        characters += locale.toString( i );
+
+    characters += locale.decimalPoint();
+    characters += locale.groupSeparator();
+    characters += locale.percent();
+    characters += locale.negativeSign();
+    characters += locale.positiveSign();
+    characters += locale.exponential();
+    characters += locale.currencySymbol();
+    characters += locale.amText();
+    characters += locale.pmText();
+
+    // the names of months and days are a good guess for the alphabet
+
+    for ( int i = 1; i <= 12; i++ )
+    {
+        characters += locale.monthName( i );
+        characters += locale.standaloneMonthName( i );
+    }
+
+    for ( int i = 1; i <= 7; i++ )
+        characters += locale.dayName( i );
+
+    return characters;
+}
+
+static QString qskUniqueCharacters( const QString& characters )
+{
+    auto codes = characters.toUcs4();
+
+    std::sort( codes.begin(), codes.end() );
+    codes.erase( std::unique( codes.begin(), codes.end() ), codes.end() );
+
+#if QT_VERSION >= QT_VERSION_CHECK( 6, 0, 0 )
+    return QString::fromUcs4(
+        reinterpret_cast< const char32_t* >( codes.constData() ), codes.size() );
+#else
+    return QString::fromUcs4( codes.constData(), codes.size() );
+#endif
+}
+
 class QskWindowPrivate : public QQuickWindowPrivate
 {
     Q_DECLARE_PUBLIC( QskWindow )
@@ -150,6 +216,10 @@ class QskWindowPrivate : public QQuickWindowPrivate
     QElapsedTimer renderInterval;
 #endif
 
+#ifdef QSK_DEBUG_SIZE_HINTS
+    quint64 cachedSizeHints = 0;
+#endif
+
     QPointer< QskSkin > skin;
 
     ChildListener contentItemListener;
@@ -160,6 +230,10 @@ class QskWindowPrivate : public QQuickWindowPrivate
 
     QskWindow::EventAcceptance eventAcceptance;
 
+    // characters for populating the glyph caches
+    QString glyphCharacters;
+    QMetaObject::Connection glyphConnection;
+
     bool explicitLocale : 1;
     bool deleteOnClose : 1;
     bool autoLayoutChildren : 1;
@@ -349,6 +423,19 @@ bool QskWindow::event( QEvent* event )
                     << d->renderInterval.restart() << objectName();
             }
 #endif
+
+#ifdef QSK_DEBUG_SIZE_HINTS
+            if ( logSizeHints().isDebugEnabled() )
+            {
+                // hint calculations, that have been avoided since the previous frame
+                const auto count = qskCachedSizeHintCount();
+
+                qCDebug( logSizeHints() ) << "cached size hints:"
+                    << count - d->cachedSizeHints << objectName();
+
+                d->cachedSizeHints = count;
+            }
+#endif
             break;
         }
 
@@ -550,6 +637,107 @@ void QskWindow::ensureFocus( Qt::FocusReason reason )
     }
 }
 
+void QskWindow::prewarmGlyphs( const QString& characters )
+{
+    class GlyphJob final : public QRunnable
+    {
+      public:
+        GlyphJob( QQuickWindow* window,
+                const QVector< QFont >& fonts, const QString& characters )
+            : m_window( window )
+            , m_fonts( fonts )
+            , m_characters( characters )
+        {
+        }
+
+        void run() override
+        {
+            auto d = QQuickWindowPrivate::get( m_window );
+
+            // other backends do not have distance field glyph caches
+            auto context = qobject_cast< QSGDefaultRenderContext* >( d->context );
+            if ( context == nullptr || !context->isValid() )
+                return;
+
+            for ( const auto& font : m_fonts )
+            {
+                const auto rawFont = QRawFont::fromFont( font );
+                if ( !rawFont.isValid() )
+                    continue;
+
+                /*
+                    The caches are shared between fonts, that differ in the size
+                    only. Glyphs being requested are rasterized and uploaded,
+                    when preprocessing the next frame.
+                 */
+#if QT_VERSION >= QT_VERSION_CHECK( 6, 0, 0 )
+                constexpr int renderQuality = -1; // QQuickText::DefaultRenderTypeQuality
+                auto cache = context->distanceFieldGlyphCache( rawFont, renderQuality );
+#else
+                auto cache = context->distanceFieldGlyphCache( rawFont );
+#endif
+                if ( cache )
+                    cache->populate( rawFont.glyphIndexesForString( m_characters ) );
+            }
+
+            QMetaObject::invokeMethod( m_window, "update" );
+        }
+
+      private:
+        QQuickWindow* m_window;
+        const QVector< QFont > m_fonts;
+        const QString m_characters;
+    };
+
+    Q_D( QskWindow );
+
+    d->glyphCharacters += characters.isEmpty()
+        ? qskLocaleCharacters( locale() ) : characters;
+
+    if ( d->glyphConnection )
+        return; // already scheduled
+
+    const auto startJob = [ this ]()
+    {
+        Q_D( QskWindow );
+
+        QVector< QFont > fonts;
+
+        if ( auto skin = qskEffectiveSkin( this ) )
+        {
+            for ( const auto& entry : skin->fonts() )
+                fonts += entry.second;
+        }
+
+        const auto characters = qskUniqueCharacters( d->glyphCharacters );
+        d->glyphCharacters.clear();
+
+        if ( !( fonts.isEmpty() || characters.isEmpty() ) )
+        {
+            scheduleRenderJob( new GlyphJob( this, fonts, characters ),
+                BeforeRenderingStage );
+            update();
+        }
+    };
+
+    /*
+        We don't want to delay the first frame, so we wait for
+        it being swapped and then for the event loop being idle.
+     */
+    d->glyphConnection = connect( this, &QQuickWindow::frameSwapped, this,
+        [ this, startJob ]()
+        {
+            disconnect( d_func()->glyphConnection );
+            d_func()->glyphConnection = QMetaObject::Connection();
+
+            QTimer::singleShot( 0, this, startJob );
+        },
+        Qt::QueuedConnection );
+
+    if ( isExposed() )
+        update();
+}
+
 void QskWindow::setCustomRenderMode( const char* mode )
 {
     class RenderJob final : public QRunnable
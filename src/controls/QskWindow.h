@@ -63,6 +63,13 @@ class QSK_EXPORT QskWindow : public QQuickWindow
 
     void polishItems();
 
+    /*
+        Populating the glyph caches of the skin fonts, when being idle
+        after the next frame. Without characters those of the locale
+        ( digits, number symbols, names of months/days ) are used.
+     */
+    void prewarmGlyphs( const QString& characters = QString() );
+
     void setCustomRenderMode( const char* mode );
     const char* customRenderMode() const;
 
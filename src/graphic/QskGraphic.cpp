@@ -16,12 +16,19 @@
 #include <qpainterpath.h>
 #include <qpixmap.h>
 #include <qhashfunctions.h>
+#include <qmutex.h>
 
 QSK_QT_PRIVATE_BEGIN
 #include <private/qpainter_p.h>
 #include <private/qpaintengineex_p.h>
 QSK_QT_PRIVATE_END
 
+static inline quint64 qskNextModificationId()
+{
+    static QAtomicInteger< quint64 > nextId( 1 );
+    return nextId.fetchAndAddRelaxed( 1 );
+}
+
 static inline qreal qskDevicePixelRatio()
 {
     return qGuiApp ? qGuiApp->devicePixelRatio() : 1.0;
@@ -209,6 +216,218 @@ static inline void qskExecCommand(
     To avoid subobject-linkage warnings, when including the source code in
     svg2qvg we don't use an anonymous namespace here
  */
+namespace QskGraphicPrivate
+{
+    /*
+        Calculating the bounding rectangle of a stroked path from its
+        elements, without creating the stroke. The outline is grown by
+        half of the pen width, what is exact for round/bevel joins and
+        flat/round caps. Miter tips and the corners of square caps are
+        added as points, so that the result is close to what
+        QPainterPathStroker creates, but never smaller.
+     */
+    class StrokeBounds
+    {
+      public:
+        StrokeBounds( const QPen& pen, const QRectF& pathRect )
+            : m_pen( pen )
+            , m_width( ( pen.widthF() > 0.0 ) ? pen.widthF() : 1.0 )
+        {
+            qreal m = 0.5 * m_width;
+
+            if ( pen.capStyle() == Qt::SquareCap && pen.style() != Qt::SolidLine )
+            {
+                // the dashes have square caps in any direction
+                m *= M_SQRT2;
+            }
+
+            m_rect = pathRect.adjusted( -m, -m, m, m );
+        }
+
+        QRectF bounds( const QPainterPath& path )
+        {
+            for ( int i = 0; i < path.elementCount(); i++ )
+            {
+                const auto e = path.elementAt( i );
+
+                switch ( e.type )
+                {
+                    case QPainterPath::MoveToElement:
+                    {
+                        endSubpath();
+                        m_start = m_pos = e;
+
+                        break;
+                    }
+                    case QPainterPath::LineToElement:
+                    {
+                        const QPointF d = QPointF( e ) - m_pos;
+                        addSegment( e, d, d );
+
+                        break;
+                    }
+                    case QPainterPath::CurveToElement:
+                    {
+                        const QPointF c1 = e;
+                        const QPointF c2 = path.elementAt( i + 1 );
+                        const QPointF p = path.elementAt( i + 2 );
+
+                        // the tangents at the start and the end of the curve
+                        QPointF d1 = c1 - m_pos;
+                        if ( d1.isNull() )
+                            d1 = ( c2 != m_pos ) ? ( c2 - m_pos ) : ( p - m_pos );
+
+                        QPointF d2 = p - c2;
+                        if ( d2.isNull() )
+                            d2 = ( p != c1 ) ? ( p - c1 ) : ( p - m_pos );
+
+                        addSegment( p, d1, d2 );
+
+                        i += 2;
+                        break;
+                    }
+                    default:
+                        break;
+                }
+            }
+
+            endSubpath();
+
+            return m_rect;
+        }
+
+      private:
+        void addSegment( const QPointF& pos, QPointF d1, QPointF d2 )
+        {
+            if ( !normalize( d1 ) || !normalize( d2 ) )
+                return; // degenerated
+
+            if ( m_hasSegment )
+                addJoin( m_pos, m_dir, d1 );
+            else
+                m_startDir = d1;
+
+            m_pos = pos;
+            m_dir = d2;
+            m_hasSegment = true;
+        }
+
+        void endSubpath()
+        {
+            if ( !m_hasSegment )
+                return;
+
+            if ( qFuzzyCompare( m_pos.x(), m_start.x() )
+                && qFuzzyCompare( m_pos.y(), m_start.y() ) )
+            {
+                addJoin( m_start, m_dir, m_startDir );
+            }
+            else if ( m_pen.capStyle() == Qt::SquareCap )
+            {
+                addSquareCap( m_start, -m_startDir );
+                addSquareCap( m_pos, m_dir );
+            }
+
+            m_hasSegment = false;
+        }
+
+        void addJoin( const QPointF& pos, const QPointF& d1, const QPointF& d2 )
+        {
+            const auto joinStyle = m_pen.joinStyle();
+
+            if ( joinStyle != Qt::MiterJoin && joinStyle != Qt::SvgMiterJoin )
+                return;
+
+            const qreal cosTurn = QPointF::dotProduct( d1, d2 );
+
+            // the distance of the tip from the join point
+            const qreal sinHalf = qSqrt( 0.5 * ( 1.0 + cosTurn ) );
+            const qreal maxDistance = 0.5 * m_width * m_pen.miterLimit();
+
+            qreal distance = ( sinHalf > 0.0 ) ? 0.5 * m_width / sinHalf : maxDistance + 1.0;
+
+            if ( distance > maxDistance )
+            {
+                if ( joinStyle == Qt::SvgMiterJoin )
+                    return; // falling back to a bevel join
+
+                // the miter gets clipped
+                const qreal m = maxDistance + 0.5 * m_width;
+                m_rect |= QRectF( pos.x() - m, pos.y() - m, 2 * m, 2 * m );
+
+                return;
+            }
+
+            auto direction = d1 - d2;
+            if ( normalize( direction ) )
+                addPoint( pos + distance * direction );
+        }
+
+        void addSquareCap( const QPointF& pos, const QPointF& d )
+        {
+            const qreal hw = 0.5 * m_width;
+            const QPointF n( -d.y(), d.x() );
+
+            addPoint( pos + hw * ( d + n ) );
+            addPoint( pos + hw * ( d - n ) );
+        }
+
+        inline void addPoint( const QPointF& pos )
+        {
+            // QRectF::operator|= ignores rectangles of size 0
+            m_rect.setLeft( qMin( m_rect.left(), pos.x() ) );
+            m_rect.setRight( qMax( m_rect.right(), pos.x() ) );
+            m_rect.setTop( qMin( m_rect.top(), pos.y() ) );
+            m_rect.setBottom( qMax( m_rect.bottom(), pos.y() ) );
+        }
+
+        static inline bool normalize( QPointF& d )
+        {
+            const qreal length = qSqrt( QPointF::dotProduct( d, d ) );
+            if ( length <= 0.0 )
+                return false;
+
+            d /= length;
+            return true;
+        }
+
+        const QPen m_pen;
+        const qreal m_width;
+
+        QRectF m_rect;
+
+        QPointF m_start;
+        QPointF m_startDir;
+
+        QPointF m_pos;
+        QPointF m_dir;
+
+        bool m_hasSegment = false;
+    };
+}
+
+static QRectF qskStrokedPathBounds( const QPainter* painter,
+    const QPainterPath& path, const QPainterPath& scaledPath, const QRectF& pointRect )
+{
+    /*
+        Creating the stroke is expensive. So we grow the geometry
+        by the outline calculated from the path elements instead.
+     */
+
+    const auto pen = painter->pen();
+
+    if ( qskHasScalablePen( painter ) )
+    {
+        const auto& transform = painter->transform();
+
+        QskGraphicPrivate::StrokeBounds strokeBounds( pen, path.boundingRect() );
+        return transform.mapRect( strokeBounds.bounds( path ) );
+    }
+
+    QskGraphicPrivate::StrokeBounds strokeBounds( pen, pointRect );
+    return strokeBounds.bounds( scaledPath );
+}
+
 namespace QskGraphicPrivate
 {
     class PathInfo
@@ -318,6 +537,10 @@ namespace QskGraphicPrivate
             return sy;
         }
 
+        inline QRectF pointRect() const { return m_pointRect; }
+        inline QRectF boundingRect() const { return m_boundingRect; }
+        inline bool isScalablePen() const { return m_scalablePen; }
+
       private:
         QRectF m_pointRect;
         QRectF m_boundingRect;
@@ -344,6 +567,7 @@ class QskGraphic::PrivateData : public QSharedData
         , modificationId( other.modificationId )
         , commandTypes( other.commandTypes )
         , renderHints( other.renderHints )
+        , exactStrokes( other.exactStrokes )
     {
     }
 
@@ -357,13 +581,12 @@ class QskGraphic::PrivateData : public QSharedData
     inline void addCommand( const QskPainterCommand& command )
     {
         commands += command;
-
-        static QAtomicInteger< quint64 > nextId( 1 );
-        modificationId = nextId.fetchAndAddRelaxed( 1 );
+        modificationId = qskNextModificationId();
     }
 
     QSizeF defaultSize;
     QVector< QskPainterCommand > commands;
+
     QVector< QskGraphicPrivate::PathInfo > pathInfos;
 
     QRectF boundingRect = { 0.0, 0.0, -1.0, -1.0 };
@@ -373,8 +596,35 @@ class QskGraphic::PrivateData : public QSharedData
 
     uint commandTypes : 4;
     uint renderHints : 4;
+
+    // using QPainterPathStroker for the bounding rectangles
+    bool exactStrokes = false;
+
+    // the results of the previous requests
+    mutable struct
+    {
+        quint64 modificationId = 0;
+        QRectF rect;
+    } exactBoundingRect;
+
+    /*
+        Scaling a single PathInfo is cheap, it is iterating over all of them,
+        what is expensive for large graphics. So the cache is for the result
+        and not per PathInfo. Layout code usually asks several times for the
+        same scale in a row, so one entry is enough.
+     */
+    mutable struct
+    {
+        quint64 modificationId = 0;
+        uint renderHints = 0;
+        qreal sx = 1.0;
+        qreal sy = 1.0;
+        QRectF rect;
+    } scaledBoundingRect;
 };
 
+static QMutex qskCacheMutex;
+
 QskGraphic::QskGraphic()
     : m_data( new PrivateData() )
     , m_paintEngine( nullptr )
@@ -553,11 +803,55 @@ QRectF QskGraphic::controlPointRect() const
     return m_data->pointRect;
 }
 
+QRectF QskGraphic::exactBoundingRect() const
+{
+    if ( !( m_data->commandTypes & VectorData ) || m_data->exactStrokes )
+        return boundingRect();
+
+    {
+        QMutexLocker locker( &qskCacheMutex );
+
+        const auto& cache = m_data->exactBoundingRect;
+        if ( cache.modificationId == m_data->modificationId )
+            return cache.rect;
+    }
+
+    // replaying the commands with calculating the exact strokes
+
+    QskGraphic graphic;
+    graphic.m_data->exactStrokes = true;
+    graphic.setCommands( m_data->commands );
+
+    const auto rect = graphic.boundingRect();
+
+    QMutexLocker locker( &qskCacheMutex );
+
+    auto& cache = m_data->exactBoundingRect;
+    cache.modificationId = m_data->modificationId;
+    cache.rect = rect;
+
+    return rect;
+}
+
 QRectF QskGraphic::scaledBoundingRect( qreal sx, qreal sy ) const
 {
     if ( sx == 1.0 && sy == 1.0 )
         return m_data->boundingRect;
 
+    {
+        QMutexLocker locker( &qskCacheMutex );
+
+        // layout code usually asks several times for the same scale
+        const auto& cache = m_data->scaledBoundingRect;
+
+        if ( cache.modificationId == m_data->modificationId
+            && cache.renderHints == m_data->renderHints
+            && cache.sx == sx && cache.sy == sy )
+        {
+            return cache.rect;
+        }
+    }
+
     const bool scalePens = !( m_data->renderHints & RenderPensUnscaled );
 
     QTransform transform;
@@ -565,9 +859,18 @@ QRectF QskGraphic::scaledBoundingRect( qreal sx, qreal sy ) const
 
     QRectF rect = transform.mapRect( m_data->pointRect );
 
-    for ( const auto& info : qAsConst( m_data->pathInfos ) )
+    for ( const auto& info : m_data->pathInfos )
         rect |= info.scaledBoundingRect( sx, sy, scalePens );
 
+    QMutexLocker locker( &qskCacheMutex );
+
+    auto& cache = m_data->scaledBoundingRect;
+    cache.modificationId = m_data->modificationId;
+    cache.renderHints = m_data->renderHints;
+    cache.sx = sx;
+    cache.sy = sy;
+    cache.rect = rect;
+
     return rect;
 }
 
@@ -678,7 +981,7 @@ void QskGraphic::render( QPainter* painter, const QRectF& rect,
 
     const bool scalePens = !( m_data->renderHints & RenderPensUnscaled );
 
-    for ( const auto& info : qAsConst( m_data->pathInfos ) )
+    for ( const auto& info : m_data->pathInfos )
     {
         const qreal ssx = info.scaleFactorX(
             m_data->pointRect, rect, scalePens );
@@ -886,7 +1189,9 @@ void QskGraphic::drawPath( const QPainterPath& path )
         if ( painter->pen().style() != Qt::NoPen &&
             painter->pen().brush().style() != Qt::NoBrush )
         {
-            boundingRect = qskStrokedPathRect( painter, path );
+            boundingRect = m_data->exactStrokes
+                ? qskStrokedPathRect( painter, path )
+                : qskStrokedPathBounds( painter, path, scaledPath, pointRect );
         }
 
         updateControlPointRect( pointRect );
@@ -1008,6 +1313,72 @@ void QskGraphic::setCommands( const QVector< QskPainterCommand >& commands )
     painter.end();
 }
 
+void QskGraphic::setCommands( const QVector< QskPainterCommand >& commands,
+    CommandTypes commandTypes, const QRectF& boundingRect,
+    const QRectF& controlPointRect, const QVector< PathGeometry >& pathGeometries )
+{
+    reset();
+
+    if ( commands.isEmpty() )
+        return;
+
+    m_data->commands = commands;
+    m_data->commandTypes = commandTypes;
+
+    if ( !boundingRect.isNull() )
+        m_data->boundingRect = boundingRect;
+
+    if ( !controlPointRect.isNull() )
+        m_data->pointRect = controlPointRect;
+
+    m_data->pathInfos.reserve( pathGeometries.size() );
+
+    for ( const auto& geometry : pathGeometries )
+    {
+        m_data->pathInfos += QskGraphicPrivate::PathInfo( geometry.pointRect,
+            geometry.boundingRect, geometry.scalablePen );
+    }
+
+    m_data->modificationId = qskNextModificationId();
+}
+
+QVector< QskGraphic::PathGeometry > QskGraphic::exactPathGeometries(
+    QRectF* boundingRect ) const
+{
+    QskGraphic graphic;
+
+    if ( m_data->exactStrokes )
+    {
+        graphic = *this;
+    }
+    else
+    {
+        // replaying the commands with calculating the exact strokes
+        graphic.m_data->exactStrokes = true;
+        graphic.setCommands( m_data->commands );
+    }
+
+    if ( boundingRect )
+        *boundingRect = graphic.boundingRect();
+
+    const auto& pathInfos = qAsConst( graphic ).m_data->pathInfos;
+
+    QVector< PathGeometry > geometries;
+    geometries.reserve( pathInfos.size() );
+
+    for ( const auto& info : pathInfos )
+    {
+        PathGeometry geometry;
+        geometry.pointRect = info.pointRect();
+        geometry.boundingRect = info.boundingRect();
+        geometry.scalablePen = info.isScalablePen();
+
+        geometries += geometry;
+    }
+
+    return geometries;
+}
+
 quint64 QskGraphic::modificationId() const
 {
     return m_data->modificationId;
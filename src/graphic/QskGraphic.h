@@ -11,6 +11,7 @@
 #include <qmetatype.h>
 #include <qflags.h>
 #include <qpaintdevice.h>
+#include <qrect.h>
 #include <qshareddata.h>
 
 class QskPainterCommand;
@@ -103,6 +104,13 @@ class QSK_EXPORT QskGraphic : public QPaintDevice
     QRectF boundingRect() const;
     QRectF controlPointRect() const;
 
+    /*
+        The bounding rectangles of stroked paths are calculated from
+        the pen width, what might be slightly larger than the outline.
+        exactBoundingRect() creates the strokes - what is expensive.
+     */
+    QRectF exactBoundingRect() const;
+
     const QVector< QskPainterCommand >& commands() const;
     void setCommands( const QVector< QskPainterCommand >& );
 
@@ -143,6 +151,31 @@ class QSK_EXPORT QskGraphic : public QPaintDevice
 
     virtual void updateState( const QPaintEngineState& state );
 
+    // the geometry of a path, as being calculated when recording it
+    class PathGeometry
+    {
+      public:
+        QRectF pointRect;
+        QRectF boundingRect;
+        bool scalablePen = false;
+    };
+
+    /*
+        Assigning commands together with the geometries, that have been
+        calculated when recording them, so that the commands don't need
+        to be replayed. Intended for loaders of precompiled formats.
+     */
+    void setCommands( const QVector< QskPainterCommand >&, CommandTypes,
+        const QRectF& boundingRect, const QRectF& controlPointRect,
+        const QVector< PathGeometry >& );
+
+    /*
+        The geometries of the paths and the bounding rectangle,
+        calculated with creating the strokes. Intended for writers
+        of precompiled formats.
+     */
+    QVector< PathGeometry > exactPathGeometries( QRectF* boundingRect ) const;
+
   private:
     void updateBoundingRect( const QRectF& );
     void updateControlPointRect( const QRectF& );
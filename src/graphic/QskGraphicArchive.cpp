@@ -0,0 +1,387 @@
+/******************************************************************************
+ * QSkinny - Copyright (C) 2016 Uwe Rathmann
+ * This file may be used under the terms of the QSkinny License, Version 1.0
+ *****************************************************************************/
+
+#include "QskGraphicArchive.h"
+#include "QskGraphic.h"
+#include "QskGraphicIO.h"
+
+#include <qbytearray.h>
+#include <qfile.h>
+#include <qvector.h>
+
+#include <cstring>
+
+static const char qskArchiveMagicNumber[] = "QSKA";
+static const quint16 qskArchiveVersion = 1;
+static const quint16 qskArchiveByteOrderMark = 0x0102;
+
+/*
+    Layout of an archive:
+
+        Header
+        quint32 buckets[ bucketCount ]
+        Entry[ entryCount ]
+        names ( UTF-8 )
+        data of the graphics
+
+    The buckets are an open addressing hash table with linear probing.
+    A bucket contains the index of an entry + 1 or 0, when being empty.
+    All entries and graphics are 8 byte aligned, so that the graphics
+    can be used directly from the mapped file.
+ */
+namespace QskGraphicArchivePrivate
+{
+    struct Header
+    {
+        char magic[ 4 ];
+        quint16 version;
+        quint16 byteOrder;
+
+        quint32 entryCount;
+        quint32 bucketCount; // power of 2
+    };
+
+    struct Entry
+    {
+        quint32 hash;
+        quint32 nameSize;
+        quint64 nameOffset;
+
+        quint64 dataOffset;
+        quint64 dataSize;
+    };
+
+    static_assert( sizeof( Header ) % 8 == 0, "Bad alignment" );
+    static_assert( sizeof( Entry ) % 8 == 0, "Bad alignment" );
+}
+
+static inline quint32 qskArchiveHash( const char* name, int size )
+{
+    // FNV-1a: we need values, that do not depend on Qt versions or seeds
+
+    quint32 hash = 2166136261u;
+
+    for ( int i = 0; i < size; i++ )
+    {
+        hash ^= static_cast< quint8 >( name[ i ] );
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static inline quint64 qskArchiveAligned( quint64 offset )
+{
+    return ( offset + 7 ) & ~quint64( 7 );
+}
+
+class QskGraphicArchive::PrivateData
+{
+  public:
+    inline bool isInside( quint64 offset, quint64 length ) const
+    {
+        return ( offset <= quint64( size ) ) && ( length <= quint64( size ) - offset );
+    }
+
+    int indexOf( const QString& id ) const
+    {
+        if ( header == nullptr || header->bucketCount == 0 )
+            return -1;
+
+        const auto name = id.toUtf8();
+        const auto hash = qskArchiveHash( name.constData(), name.size() );
+
+        const auto mask = header->bucketCount - 1;
+
+        for ( quint32 i = 0; i < header->bucketCount; i++ )
+        {
+            const auto bucket = buckets[ ( hash + i ) & mask ];
+            if ( bucket == 0 || bucket > header->entryCount )
+                return -1;
+
+            const auto& entry = entries[ bucket - 1 ];
+
+            if ( entry.hash == hash && entry.nameSize == quint32( name.size() )
+                && isInside( entry.nameOffset, entry.nameSize )
+                && memcmp( data + entry.nameOffset, name.constData(), name.size() ) == 0 )
+            {
+                return bucket - 1;
+            }
+        }
+
+        return -1;
+    }
+
+    QString fileName;
+
+    std::shared_ptr< const void > storage;
+    const char* data = nullptr;
+    qint64 size = 0;
+
+    const QskGraphicArchivePrivate::Header* header = nullptr;
+    const quint32* buckets = nullptr;
+    const QskGraphicArchivePrivate::Entry* entries = nullptr;
+};
+
+QskGraphicArchive::QskGraphicArchive()
+    : m_data( new PrivateData() )
+{
+}
+
+QskGraphicArchive::QskGraphicArchive( const QString& fileName )
+    : QskGraphicArchive()
+{
+    load( fileName );
+}
+
+QskGraphicArchive::~QskGraphicArchive()
+{
+}
+
+bool QskGraphicArchive::load( const QString& fileName )
+{
+    using namespace QskGraphicArchivePrivate;
+
+    unload();
+
+    const auto file = std::make_shared< QFile >( fileName );
+    if ( !file->open( QIODevice::ReadOnly ) )
+    {
+        qWarning( "QskGraphicArchive: can't open %s", qPrintable( fileName ) );
+        return false;
+    }
+
+    const auto size = file->size();
+
+    std::shared_ptr< const void > storage = file;
+    auto data = reinterpret_cast< const char* >( file->map( 0, size ) );
+
+    if ( data == nullptr || ( reinterpret_cast< quintptr >( data ) % 8 ) )
+    {
+        // f.e. compressed resources
+        const auto bytes = std::make_shared< QByteArray >( file->readAll() );
+
+        storage = bytes;
+        data = bytes->constData();
+    }
+
+    // the mapping stays valid as long as the QFile object is alive
+    file->close();
+
+    if ( size < qint64( sizeof( Header ) ) )
+    {
+        qWarning( "QskGraphicArchive: invalid file %s", qPrintable( fileName ) );
+        return false;
+    }
+
+    const auto header = reinterpret_cast< const Header* >( data );
+
+    if ( memcmp( header->magic, qskArchiveMagicNumber, 4 ) != 0
+        || header->version != qskArchiveVersion
+        || header->byteOrder != qskArchiveByteOrderMark )
+    {
+        qWarning( "QskGraphicArchive: invalid or unsupported file %s",
+            qPrintable( fileName ) );
+
+        return false;
+    }
+
+    const auto bucketCount = header->bucketCount;
+
+    const auto entriesOffset = qskArchiveAligned(
+        sizeof( Header ) + quint64( bucketCount ) * sizeof( quint32 ) );
+
+    const auto entriesEnd = entriesOffset + quint64( header->entryCount ) * sizeof( Entry );
+
+    if ( ( bucketCount & ( bucketCount - 1 ) ) || entriesEnd > quint64( size ) )
+    {
+        qWarning( "QskGraphicArchive: invalid file %s", qPrintable( fileName ) );
+        return false;
+    }
+
+    m_data->fileName = fileName;
+    m_data->storage = storage;
+    m_data->data = data;
+    m_data->size = size;
+    m_data->header = header;
+    m_data->buckets = reinterpret_cast< const quint32* >( header + 1 );
+    m_data->entries = reinterpret_cast< const Entry* >( data + entriesOffset );
+
+    return true;
+}
+
+void QskGraphicArchive::unload()
+{
+    /*
+        Graphics, that have been created from the archive keep
+        a reference to the storage, so we can release it here.
+     */
+    m_data.reset( new PrivateData() );
+}
+
+bool QskGraphicArchive::isNull() const
+{
+    return m_data->header == nullptr;
+}
+
+QString QskGraphicArchive::fileName() const
+{
+    return m_data->fileName;
+}
+
+int QskGraphicArchive::count() const
+{
+    return m_data->header ? static_cast< int >( m_data->header->entryCount ) : 0;
+}
+
+QStringList QskGraphicArchive::ids() const
+{
+    QStringList ids;
+    ids.reserve( count() );
+
+    for ( int i = 0; i < count(); i++ )
+    {
+        const auto& entry = m_data->entries[ i ];
+
+        if ( m_data->isInside( entry.nameOffset, entry.nameSize ) )
+        {
+            ids += QString::fromUtf8(
+                m_data->data + entry.nameOffset, entry.nameSize );
+        }
+    }
+
+    return ids;
+}
+
+bool QskGraphicArchive::contains( const QString& id ) const
+{
+    return m_data->indexOf( id ) >= 0;
+}
+
+QskGraphic QskGraphicArchive::graphic( const QString& id ) const
+{
+    const auto index = m_data->indexOf( id );
+    if ( index < 0 )
+        return QskGraphic();
+
+    const auto& entry = m_data->entries[ index ];
+
+    if ( !m_data->isInside( entry.dataOffset, entry.dataSize ) )
+    {
+        qWarning( "QskGraphicArchive: invalid entry %s", qPrintable( id ) );
+        return QskGraphic();
+    }
+
+    return QskGraphicIO::read( m_data->data + entry.dataOffset,
+        entry.dataSize, m_data->storage );
+}
+
+bool QskGraphicArchive::write(
+    const QMap< QString, QByteArray >& graphics, const QString& fileName )
+{
+    using namespace QskGraphicArchivePrivate;
+
+    const quint32 entryCount = graphics.size();
+
+    quint32 bucketCount = 1;
+    while ( bucketCount < 2 * entryCount )
+        bucketCount <<= 1;
+
+    QVector< quint32 > buckets( bucketCount, 0 );
+    QVector< Entry > entries;
+    entries.reserve( entryCount );
+
+    QByteArray names;
+
+    const quint64 entriesOffset = qskArchiveAligned(
+        sizeof( Header ) + quint64( bucketCount ) * sizeof( quint32 ) );
+
+    const quint64 namesOffset = entriesOffset + quint64( entryCount ) * sizeof( Entry );
+
+    for ( auto it = graphics.constBegin(); it != graphics.constEnd(); ++it )
+    {
+        const auto name = it.key().toUtf8();
+
+        Entry entry;
+        memset( &entry, 0, sizeof( entry ) );
+
+        entry.hash = qskArchiveHash( name.constData(), name.size() );
+        entry.nameSize = name.size();
+        entry.nameOffset = namesOffset + names.size();
+
+        names += name;
+
+        const auto mask = bucketCount - 1;
+        for ( quint32 i = 0; ; i++ )
+        {
+            auto& bucket = buckets[ ( entry.hash + i ) & mask ];
+            if ( bucket == 0 )
+            {
+                bucket = entries.size() + 1;
+                break;
+            }
+        }
+
+        entries += entry;
+    }
+
+    quint64 dataOffset = qskArchiveAligned( namesOffset + names.size() );
+
+    {
+        int i = 0;
+        for ( auto it = graphics.constBegin(); it != graphics.constEnd(); ++it, ++i )
+        {
+            entries[ i ].dataOffset = dataOffset;
+            entries[ i ].dataSize = it.value().size();
+
+            dataOffset = qskArchiveAligned( dataOffset + it.value().size() );
+        }
+    }
+
+    Header header;
+    memset( &header, 0, sizeof( header ) );
+
+    memcpy( header.magic, qskArchiveMagicNumber, 4 );
+    header.version = qskArchiveVersion;
+    header.byteOrder = qskArchiveByteOrderMark;
+    header.entryCount = entryCount;
+    header.bucketCount = bucketCount;
+
+    QFile file( fileName );
+    if ( !file.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+    {
+        qWarning( "QskGraphicArchive: can't open %s", qPrintable( fileName ) );
+        return false;
+    }
+
+    const auto writeData = [ &file ]( const void* data, qint64 size )
+    {
+        return ( size == 0 ) ||
+            ( file.write( static_cast< const char* >( data ), size ) == size );
+    };
+
+    const auto writePadding = [ &file ]() -> bool
+    {
+        static const char zeros[ 8 ] = {};
+
+        const auto padding = qskArchiveAligned( file.pos() ) - file.pos();
+        return ( padding == 0 ) || ( file.write( zeros, padding ) == qint64( padding ) );
+    };
+
+    bool ok = writeData( &header, sizeof( header ) )
+        && writeData( buckets.constData(), buckets.size() * sizeof( quint32 ) )
+        && writePadding()
+        && writeData( entries.constData(), entries.size() * sizeof( Entry ) )
+        && writeData( names.constData(), names.size() )
+        && writePadding();
+
+    for ( auto it = graphics.constBegin(); ok && it != graphics.constEnd(); ++it )
+    {
+        ok = writeData( it.value().constData(), it.value().size() )
+            && writePadding();
+    }
+
+    return ok;
+}
@@ -0,0 +1,58 @@
+/******************************************************************************
+ * QSkinny - Copyright (C) 2016 Uwe Rathmann
+ * This file may be used under the terms of the QSkinny License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QSK_GRAPHIC_ARCHIVE_H
+#define QSK_GRAPHIC_ARCHIVE_H
+
+#include "QskGlobal.h"
+
+#include <qmap.h>
+#include <qstringlist.h>
+
+#include <memory>
+
+class QskGraphic;
+class QByteArray;
+
+/*
+    A single file with many graphics, that can be looked up by
+    their ids. The file is memory mapped and the graphics are
+    created from the mapped data without copying it.
+
+    Archives are usually created by svg2qvg from a directory
+    of SVG files or a manifest.
+ */
+class QSK_EXPORT QskGraphicArchive
+{
+  public:
+    QskGraphicArchive();
+    QskGraphicArchive( const QString& fileName );
+
+    ~QskGraphicArchive();
+
+    bool load( const QString& fileName );
+    void unload();
+
+    bool isNull() const;
+
+    QString fileName() const;
+
+    int count() const;
+    QStringList ids() const;
+
+    bool contains( const QString& id ) const;
+    QskGraphic graphic( const QString& id ) const;
+
+    // id -> data written by QskGraphicIO::write
+    static bool write( const QMap< QString, QByteArray >&, const QString& fileName );
+
+  private:
+    Q_DISABLE_COPY( QskGraphicArchive )
+
+    class PrivateData;
+    std::unique_ptr< PrivateData > m_data;
+};
+
+#endif
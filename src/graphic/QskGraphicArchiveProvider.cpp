@@ -0,0 +1,56 @@
+/******************************************************************************
+ * QSkinny - Copyright (C) 2016 Uwe Rathmann
+ * This file may be used under the terms of the QSkinny License, Version 1.0
+ *****************************************************************************/
+
+#include "QskGraphicArchiveProvider.h"
+#include "QskGraphic.h"
+
+QskGraphicArchiveProvider::QskGraphicArchiveProvider( QObject* parent )
+    : QskGraphicProvider( parent )
+{
+}
+
+QskGraphicArchiveProvider::QskGraphicArchiveProvider(
+        const QString& fileName, QObject* parent )
+    : QskGraphicProvider( parent )
+{
+    m_archive.load( fileName );
+}
+
+QskGraphicArchiveProvider::~QskGraphicArchiveProvider()
+{
+    cancelPrefetch();
+}
+
+void QskGraphicArchiveProvider::setFileName( const QString& fileName )
+{
+    if ( fileName == m_archive.fileName() )
+        return;
+
+    cancelPrefetch();
+    clearCache();
+
+    if ( fileName.isEmpty() )
+        m_archive.unload();
+    else
+        m_archive.load( fileName );
+}
+
+QString QskGraphicArchiveProvider::fileName() const
+{
+    return m_archive.fileName();
+}
+
+const QskGraphicArchive& QskGraphicArchiveProvider::archive() const
+{
+    return m_archive;
+}
+
+const QskGraphic* QskGraphicArchiveProvider::loadGraphic( const QString& id ) const
+{
+    const auto graphic = m_archive.graphic( id );
+    return graphic.isNull() ? nullptr : new QskGraphic( graphic );
+}
+
+#include "moc_QskGraphicArchiveProvider.cpp"
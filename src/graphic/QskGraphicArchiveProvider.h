@@ -0,0 +1,36 @@
+/******************************************************************************
+ * QSkinny - Copyright (C) 2016 Uwe Rathmann
+ * This file may be used under the terms of the QSkinny License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QSK_GRAPHIC_ARCHIVE_PROVIDER_H
+#define QSK_GRAPHIC_ARCHIVE_PROVIDER_H
+
+#include "QskGraphicProvider.h"
+#include "QskGraphicArchive.h"
+
+class QSK_EXPORT QskGraphicArchiveProvider : public QskGraphicProvider
+{
+    Q_OBJECT
+
+    Q_PROPERTY( QString fileName READ fileName WRITE setFileName )
+
+  public:
+    QskGraphicArchiveProvider( QObject* parent = nullptr );
+    QskGraphicArchiveProvider( const QString& fileName, QObject* parent = nullptr );
+
+    ~QskGraphicArchiveProvider() override;
+
+    void setFileName( const QString& );
+    QString fileName() const;
+
+    const QskGraphicArchive& archive() const;
+
+  protected:
+    const QskGraphic* loadGraphic( const QString& id ) const override;
+
+  private:
+    QskGraphicArchive m_archive;
+};
+
+#endif
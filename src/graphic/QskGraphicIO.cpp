@@ -12,10 +12,19 @@
 #include <qfile.h>
 #include <qvector.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
+#include <memory>
 
+// QDataStream based format of the first QVG version
 static const char qskMagicNumber[] = "QSKG";
 
+// flat format, that can be used directly from a memory mapped file
+static const char qskMagicNumberFlat[] = "QSKF";
+static const quint16 qskFlatVersion = 2;
+static const quint16 qskByteOrderMark = 0x0102;
+
 /*
     To avoid crashes ( fonts ), when svg2qvg was running with a different Qt
     version, than the one of the application we hardcode
@@ -24,12 +33,6 @@ static const char qskMagicNumber[] = "QSKG";
  */
 static const int qskDataStreamVersion = QDataStream::Qt_5_6;
 
-static inline void qskWritePathData(
-    const QPainterPath& path, QDataStream& s )
-{
-    s << path;
-}
-
 static inline void qskReadPathData(
     QDataStream& s, QVector< QskPainterCommand >& commands )
 {
@@ -39,12 +42,6 @@ static inline void qskReadPathData(
     commands += QskPainterCommand( path );
 }
 
-static inline void qskWritePixmapData(
-    const QskPainterCommand::PixmapData& data, QDataStream& s )
-{
-    s << data.rect << data.pixmap << data.subRect;
-}
-
 static inline void qskReadPixmapData(
     QDataStream& s, QVector< QskPainterCommand >& commands )
 {
@@ -57,12 +54,6 @@ static inline void qskReadPixmapData(
     commands += QskPainterCommand( data.rect, data.pixmap, data.subRect );
 }
 
-static inline void qskWriteImageData(
-    const QskPainterCommand::ImageData& data, QDataStream& s )
-{
-    s << data.rect << data.image << data.subRect;
-}
-
 static inline void qskReadImageData(
     QDataStream& s, QVector< QskPainterCommand >& commands )
 {
@@ -203,31 +194,9 @@ static inline void qskReadStateData(
     commands += QskPainterCommand( data );
 }
 
-QskGraphic QskGraphicIO::read( const QString& fileName )
-{
-    QFile file( fileName );
-    if ( file.open( QIODevice::ReadOnly ) == false )
-    {
-        qWarning( "QskGraphicIO::read can't open %s", qPrintable( fileName ) );
-        return QskGraphic();
-    }
 
-    return read( &file );
-}
-
-QskGraphic QskGraphicIO::read( const QByteArray& data )
-{
-    QBuffer buffer;
-    buffer.setData( data );
-
-    return read( &buffer );
-}
-
-QskGraphic QskGraphicIO::read( QIODevice* dev )
+static QskGraphic qskReadStream( QIODevice* dev )
 {
-    if ( dev == nullptr )
-        return QskGraphic();
-
     QDataStream stream( dev );
 #if 1
     stream.setVersion( qskDataStreamVersion );
@@ -286,74 +255,1013 @@ QskGraphic QskGraphicIO::read( QIODevice* dev )
     return graphic;
 }
 
-bool QskGraphicIO::write( const QskGraphic& graphic, const QString& fileName )
+/*
+    The flat format consists of sections of fixed size records, that
+    can be used from memory without any parsing:
+
+        Header
+        Command[ commandCount ]
+        Path[ pathCount ]
+        PathElement[ elementCount ]
+        State[ stateCount ]
+        Raster[ rasterCount ]
+        PathGeometry[ pathGeometryCount ]
+        Blob[ blobSize ]
+
+    All records are 8 byte aligned and stored in little endian byte order.
+    On big endian systems the records are swapped, what can't be done
+    without copying the data. The blob contains QDataStream encoded raster
+    data and states with attributes, that can't be represented by the
+    State record ( fonts, gradients, clip regions ... ).
+
+    QPainterPaths are built, when being rendered the first time and
+    raster data is not decoded before being needed. The geometries of
+    the paths are stored, so that calculating bounding rectangles and
+    scale factors does not need to build the paths.
+ */
+namespace QskGraphicIOPrivate
 {
-    QFile file( fileName );
-    if ( file.open( QIODevice::WriteOnly | QIODevice::Truncate ) == false )
+    struct Header
     {
-        qWarning( "QskGraphicIO::write can't open %s", qPrintable( fileName ) );
+        char magic[ 4 ];
+        quint16 version;
+        quint16 byteOrder;
+
+        quint32 commandTypes;
+        quint32 commandCount;
+        quint32 pathCount;
+        quint32 elementCount;
+        quint32 stateCount;
+        quint32 rasterCount;
+        quint32 blobSize;
+        quint32 pathGeometryCount;
+
+        double boundingRect[ 4 ];
+        double pointRect[ 4 ];
+    };
+
+    struct Command
+    {
+        quint32 type;
+        quint32 index; // into paths, states or rasters
+    };
+
+    struct Path
+    {
+        quint32 firstElement;
+        quint32 elementCount;
+        quint32 fillRule;
+        quint32 reserved;
+    };
+
+    struct PathElement
+    {
+        double x;
+        double y;
+        qint32 type;
+        qint32 reserved;
+    };
+
+    struct State
+    {
+        quint32 flags;
+        quint32 blobOffset;
+        quint32 blobSize; // > 0: state is stored in the blob
+        qint32 renderHints;
+
+        quint64 penColor;
+        quint64 brushColor;
+
+        double penWidth;
+        double miterLimit;
+        double opacity;
+        double brushOrigin[ 2 ];
+        double transform[ 9 ];
+
+        quint16 penStyle;
+        quint16 penBrushStyle;
+        quint16 capStyle;
+        quint16 joinStyle;
+        quint16 isCosmetic;
+        quint16 brushStyle;
+        quint16 compositionMode;
+        quint16 isClipEnabled;
+    };
+
+    struct Raster
+    {
+        double rect[ 4 ];
+        double subRect[ 4 ];
+
+        quint32 flags;
+        quint32 blobOffset;
+        quint32 blobSize;
+        quint32 reserved;
+    };
+
+    struct PathGeometry
+    {
+        double pointRect[ 4 ];
+        double boundingRect[ 4 ];
+
+        quint32 scalablePen;
+        quint32 reserved;
+    };
+
+    static_assert( sizeof( Header ) % 8 == 0, "Bad alignment" );
+    static_assert( sizeof( Command ) % 8 == 0, "Bad alignment" );
+    static_assert( sizeof( Path ) % 8 == 0, "Bad alignment" );
+    static_assert( sizeof( PathElement ) % 8 == 0, "Bad alignment" );
+    static_assert( sizeof( State ) % 8 == 0, "Bad alignment" );
+    static_assert( sizeof( Raster ) % 8 == 0, "Bad alignment" );
+    static_assert( sizeof( PathGeometry ) % 8 == 0, "Bad alignment" );
+
+    class Graphic : public QskGraphic
+    {
+      public:
+        using QskGraphic::PathGeometry;
+        using QskGraphic::setCommands;
+        using QskGraphic::exactPathGeometries;
+    };
+}
+
+template< typename T >
+static inline void qskSwap( T& value )
+{
+    auto bytes = reinterpret_cast< char* >( &value );
+    std::reverse( bytes, bytes + sizeof( T ) );
+}
+
+template< typename T, int N >
+static inline void qskSwap( T ( &values )[ N ] )
+{
+    for ( int i = 0; i < N; i++ )
+        qskSwap( values[ i ] );
+}
+
+static void qskSwapRecord( QskGraphicIOPrivate::Header& header )
+{
+    qskSwap( header.version );
+    qskSwap( header.byteOrder );
+    qskSwap( header.commandTypes );
+    qskSwap( header.commandCount );
+    qskSwap( header.pathCount );
+    qskSwap( header.elementCount );
+    qskSwap( header.stateCount );
+    qskSwap( header.rasterCount );
+    qskSwap( header.blobSize );
+    qskSwap( header.pathGeometryCount );
+    qskSwap( header.boundingRect );
+    qskSwap( header.pointRect );
+}
+
+static inline void qskSwapRecord( QskGraphicIOPrivate::Command& command )
+{
+    qskSwap( command.type );
+    qskSwap( command.index );
+}
+
+static inline void qskSwapRecord( QskGraphicIOPrivate::Path& path )
+{
+    qskSwap( path.firstElement );
+    qskSwap( path.elementCount );
+    qskSwap( path.fillRule );
+}
+
+static inline void qskSwapRecord( QskGraphicIOPrivate::PathElement& element )
+{
+    qskSwap( element.x );
+    qskSwap( element.y );
+    qskSwap( element.type );
+}
+
+static void qskSwapRecord( QskGraphicIOPrivate::State& state )
+{
+    qskSwap( state.flags );
+    qskSwap( state.blobOffset );
+    qskSwap( state.blobSize );
+    qskSwap( state.renderHints );
+    qskSwap( state.penColor );
+    qskSwap( state.brushColor );
+    qskSwap( state.penWidth );
+    qskSwap( state.miterLimit );
+    qskSwap( state.opacity );
+    qskSwap( state.brushOrigin );
+    qskSwap( state.transform );
+    qskSwap( state.penStyle );
+    qskSwap( state.penBrushStyle );
+    qskSwap( state.capStyle );
+    qskSwap( state.joinStyle );
+    qskSwap( state.isCosmetic );
+    qskSwap( state.brushStyle );
+    qskSwap( state.compositionMode );
+    qskSwap( state.isClipEnabled );
+}
+
+static inline void qskSwapRecord( QskGraphicIOPrivate::Raster& raster )
+{
+    qskSwap( raster.rect );
+    qskSwap( raster.subRect );
+    qskSwap( raster.flags );
+    qskSwap( raster.blobOffset );
+    qskSwap( raster.blobSize );
+}
+
+static inline void qskSwapRecord( QskGraphicIOPrivate::PathGeometry& geometry )
+{
+    qskSwap( geometry.pointRect );
+    qskSwap( geometry.boundingRect );
+    qskSwap( geometry.scalablePen );
+}
+
+template< typename T >
+static inline T* qskSwapRecords( T* records, quint32 count )
+{
+    for ( quint32 i = 0; i < count; i++ )
+        qskSwapRecord( records[ i ] );
+
+    return records + count;
+}
+
+template< typename T >
+static inline void qskSwapRecords( QVector< T >& records )
+{
+    qskSwapRecords( records.data(), records.size() );
+}
+
+static inline qint64 qskDataSize( const QskGraphicIOPrivate::Header& header )
+{
+    using namespace QskGraphicIOPrivate;
+
+    return sizeof( Header )
+        + qint64( header.commandCount ) * sizeof( Command )
+        + qint64( header.pathCount ) * sizeof( Path )
+        + qint64( header.elementCount ) * sizeof( PathElement )
+        + qint64( header.stateCount ) * sizeof( State )
+        + qint64( header.rasterCount ) * sizeof( Raster )
+        + qint64( header.pathGeometryCount ) * sizeof( PathGeometry )
+        + header.blobSize;
+}
+
+static bool qskSwapFlat( char* data, qint64 size )
+{
+    using namespace QskGraphicIOPrivate;
+
+    if ( size < qint64( sizeof( Header ) ) )
         return false;
-    }
 
-    return write( graphic, &file );
+    auto header = reinterpret_cast< Header* >( data );
+    qskSwapRecord( *header );
+
+    if ( qskDataSize( *header ) > size )
+        return false;
+
+    auto commands = reinterpret_cast< Command* >( header + 1 );
+    auto paths = reinterpret_cast< Path* >(
+        qskSwapRecords( commands, header->commandCount ) );
+    auto elements = reinterpret_cast< PathElement* >(
+        qskSwapRecords( paths, header->pathCount ) );
+    auto states = reinterpret_cast< State* >(
+        qskSwapRecords( elements, header->elementCount ) );
+    auto rasters = reinterpret_cast< Raster* >(
+        qskSwapRecords( states, header->stateCount ) );
+    auto geometries = reinterpret_cast< PathGeometry* >(
+        qskSwapRecords( rasters, header->rasterCount ) );
+
+    qskSwapRecords( geometries, header->pathGeometryCount );
+
+    // the blob is QDataStream encoded with a fixed byte order
+
+    return true;
 }
 
-bool QskGraphicIO::write( const QskGraphic& graphic, QByteArray& data )
+static inline void qskFlatRect( const QRectF& rect, double values[] )
 {
-    QBuffer buffer( &data );
-    return write( graphic, &buffer );
+    values[ 0 ] = rect.x();
+    values[ 1 ] = rect.y();
+    values[ 2 ] = rect.width();
+    values[ 3 ] = rect.height();
 }
 
-bool QskGraphicIO::write( const QskGraphic& graphic, QIODevice* dev )
+static inline QRectF qskRect( const double values[] )
 {
-    if ( dev == nullptr )
+    return QRectF( values[ 0 ], values[ 1 ], values[ 2 ], values[ 3 ] );
+}
+
+static inline bool qskIsFlatBrush( const QBrush& brush )
+{
+    return ( brush.style() < Qt::LinearGradientPattern )
+        && brush.transform().isIdentity();
+}
+
+static bool qskIsFlatState( const QskPainterCommand::StateData& data )
+{
+    const auto complexFlags = QPaintEngine::DirtyFont | QPaintEngine::DirtyBackground
+        | QPaintEngine::DirtyClipRegion | QPaintEngine::DirtyClipPath;
+
+    if ( data.flags & complexFlags )
         return false;
 
-    QDataStream stream( dev );
-#if 1
+    if ( data.flags & QPaintEngine::DirtyPen )
+    {
+        const auto& pen = data.pen;
+
+        if ( pen.style() == Qt::CustomDashLine || pen.dashOffset() != 0.0 )
+            return false;
+
+        if ( !qskIsFlatBrush( pen.brush() ) )
+            return false;
+    }
+
+    if ( data.flags & QPaintEngine::DirtyBrush )
+    {
+        if ( !qskIsFlatBrush( data.brush ) )
+            return false;
+    }
+
+    return true;
+}
+
+static QskGraphicIOPrivate::State qskFlatState( const QskPainterCommand::StateData& data )
+{
+    QskGraphicIOPrivate::State state;
+    memset( &state, 0, sizeof( state ) );
+
+    state.flags = data.flags;
+
+    if ( data.flags & QPaintEngine::DirtyPen )
+    {
+        const auto& pen = data.pen;
+
+        state.penColor = pen.color().rgba64();
+        state.penWidth = pen.widthF();
+        state.miterLimit = pen.miterLimit();
+        state.penStyle = pen.style();
+        state.penBrushStyle = pen.brush().style();
+        state.capStyle = pen.capStyle();
+        state.joinStyle = pen.joinStyle();
+        state.isCosmetic = pen.isCosmetic();
+    }
+
+    if ( data.flags & QPaintEngine::DirtyBrush )
+    {
+        state.brushColor = data.brush.color().rgba64();
+        state.brushStyle = data.brush.style();
+    }
+
+    if ( data.flags & QPaintEngine::DirtyBrushOrigin )
+    {
+        state.brushOrigin[ 0 ] = data.brushOrigin.x();
+        state.brushOrigin[ 1 ] = data.brushOrigin.y();
+    }
+
+    if ( data.flags & QPaintEngine::DirtyTransform )
+    {
+        const auto& t = data.transform;
+
+        const qreal values[] = { t.m11(), t.m12(), t.m13(),
+            t.m21(), t.m22(), t.m23(), t.m31(), t.m32(), t.m33() };
+
+        for ( int i = 0; i < 9; i++ )
+            state.transform[ i ] = values[ i ];
+    }
+
+    if ( data.flags & QPaintEngine::DirtyClipEnabled )
+        state.isClipEnabled = data.isClipEnabled;
+
+    if ( data.flags & QPaintEngine::DirtyHints )
+        state.renderHints = static_cast< qint32 >( data.renderHints );
+
+    if ( data.flags & QPaintEngine::DirtyCompositionMode )
+        state.compositionMode = data.compositionMode;
+
+    if ( data.flags & QPaintEngine::DirtyOpacity )
+        state.opacity = data.opacity;
+
+    return state;
+}
+
+static QskPainterCommand::StateData qskStateData(
+    const QskGraphicIOPrivate::State& state )
+{
+    QskPainterCommand::StateData data;
+    data.flags = ( QPaintEngine::DirtyFlags ) state.flags;
+
+    if ( data.flags & QPaintEngine::DirtyPen )
+    {
+        const QBrush brush( QColor::fromRgba64( QRgba64::fromRgba64( state.penColor ) ),
+            static_cast< Qt::BrushStyle >( state.penBrushStyle ) );
+
+        QPen pen( brush, state.penWidth,
+            static_cast< Qt::PenStyle >( state.penStyle ),
+            static_cast< Qt::PenCapStyle >( state.capStyle ),
+            static_cast< Qt::PenJoinStyle >( state.joinStyle ) );
+
+        pen.setMiterLimit( state.miterLimit );
+        pen.setCosmetic( state.isCosmetic );
+
+        data.pen = pen;
+    }
+
+    if ( data.flags & QPaintEngine::DirtyBrush )
+    {
+        data.brush = QBrush( QColor::fromRgba64( QRgba64::fromRgba64( state.brushColor ) ),
+            static_cast< Qt::BrushStyle >( state.brushStyle ) );
+    }
+
+    if ( data.flags & QPaintEngine::DirtyBrushOrigin )
+        data.brushOrigin = QPointF( state.brushOrigin[ 0 ], state.brushOrigin[ 1 ] );
+
+    if ( data.flags & QPaintEngine::DirtyTransform )
+    {
+        const auto t = state.transform;
+        data.transform.setMatrix( t[ 0 ], t[ 1 ], t[ 2 ],
+            t[ 3 ], t[ 4 ], t[ 5 ], t[ 6 ], t[ 7 ], t[ 8 ] );
+    }
+
+    if ( data.flags & QPaintEngine::DirtyClipEnabled )
+        data.isClipEnabled = state.isClipEnabled;
+
+    if ( data.flags & QPaintEngine::DirtyHints )
+        data.renderHints = static_cast< QPainter::RenderHints >( state.renderHints );
+
+    if ( data.flags & QPaintEngine::DirtyCompositionMode )
+    {
+        data.compositionMode =
+            static_cast< QPainter::CompositionMode >( state.compositionMode );
+    }
+
+    if ( data.flags & QPaintEngine::DirtyOpacity )
+        data.opacity = state.opacity;
+
+    return data;
+}
+
+static QPainterPath qskPath( const QskGraphicIOPrivate::PathElement* elements,
+    int count, Qt::FillRule fillRule )
+{
+    QPainterPath path;
+    path.setFillRule( fillRule );
+    path.reserve( count );
+
+    for ( int i = 0; i < count; i++ )
+    {
+        const auto& e = elements[ i ];
+
+        switch ( e.type )
+        {
+            case QPainterPath::MoveToElement:
+            {
+                path.moveTo( e.x, e.y );
+                break;
+            }
+            case QPainterPath::LineToElement:
+            {
+                path.lineTo( e.x, e.y );
+                break;
+            }
+            case QPainterPath::CurveToElement:
+            {
+                if ( i + 2 < count )
+                {
+                    const auto& c2 = elements[ i + 1 ];
+                    const auto& end = elements[ i + 2 ];
+
+                    path.cubicTo( e.x, e.y, c2.x, c2.y, end.x, end.y );
+                }
+
+                i += 2;
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    return path;
+}
+
+template< typename T >
+static inline T qskDecoded( const char* data, int size )
+{
+    const auto bytes = QByteArray::fromRawData( data, size );
+
+    QDataStream stream( bytes );
     stream.setVersion( qskDataStreamVersion );
-#endif
     stream.setByteOrder( QDataStream::BigEndian );
-    stream.writeRawData( qskMagicNumber, 4 );
 
-    const int numCommands = graphic.commands().size();
-    const QskPainterCommand* cmds = graphic.commands().constData();
+    T value;
+    stream >> value;
 
-    stream << static_cast< quint32 >( numCommands );
+    return value;
+}
+
+template< typename Encode >
+static inline void qskAppendBlob( QByteArray& blob,
+    quint32& offset, quint32& size, Encode encode )
+{
+    offset = blob.size();
 
-    for ( int i = 0; i < numCommands; i++ )
     {
-        stream << static_cast< quint8 >( cmds[ i ].type() );
+        QDataStream stream( &blob, QIODevice::Append );
+        stream.setVersion( qskDataStreamVersion );
+        stream.setByteOrder( QDataStream::BigEndian );
+
+        encode( stream );
+    }
+
+    size = blob.size() - offset;
+}
 
-        switch ( cmds[ i ].type() )
+static inline bool qskIsFlat( const char* data, qint64 size )
+{
+    return ( size >= 4 ) && ( memcmp( data, qskMagicNumberFlat, 4 ) == 0 );
+}
+
+static QskGraphic qskReadFlatAligned( const char* data, qint64 size,
+    const std::shared_ptr< const void >& storage )
+{
+    using namespace QskGraphicIOPrivate;
+
+    if ( size < qint64( sizeof( Header ) ) )
+    {
+        qWarning( "QskGraphicIO::read: invalid data" );
+        return QskGraphic();
+    }
+
+    const auto header = reinterpret_cast< const Header* >( data );
+
+    if ( header->byteOrder != qskByteOrderMark )
+    {
+        qWarning( "QskGraphicIO::read: unsupported byte order" );
+        return QskGraphic();
+    }
+
+    if ( header->version != qskFlatVersion )
+    {
+        qWarning( "QskGraphicIO::read: unsupported version %d", header->version );
+        return QskGraphic();
+    }
+
+    if ( qskDataSize( *header ) > size )
+    {
+        qWarning( "QskGraphicIO::read: invalid data" );
+        return QskGraphic();
+    }
+
+    const auto commands = reinterpret_cast< const Command* >( header + 1 );
+    const auto paths = reinterpret_cast< const Path* >( commands + header->commandCount );
+    const auto elements = reinterpret_cast< const PathElement* >( paths + header->pathCount );
+    const auto states = reinterpret_cast< const State* >( elements + header->elementCount );
+    const auto rasters = reinterpret_cast< const Raster* >( states + header->stateCount );
+    const auto pathGeometries = reinterpret_cast< const PathGeometry* >(
+        rasters + header->rasterCount );
+    const auto blob = reinterpret_cast< const char* >(
+        pathGeometries + header->pathGeometryCount );
+
+    const auto isInBlob = [ header ]( quint32 offset, quint32 size )
+        { return qint64( offset ) + size <= header->blobSize; };
+
+    QVector< QskPainterCommand > cmds;
+    cmds.reserve( header->commandCount );
+
+    for ( quint32 i = 0; i < header->commandCount; i++ )
+    {
+        const auto& command = commands[ i ];
+
+        switch ( command.type )
         {
             case QskPainterCommand::Path:
             {
-                qskWritePathData( *cmds[ i ].path(), stream );
+                if ( command.index >= header->pathCount )
+                    return QskGraphic();
+
+                const auto& path = paths[ command.index ];
+
+                if ( qint64( path.firstElement ) + path.elementCount > header->elementCount )
+                    return QskGraphic();
+
+                const auto pathElements = elements + path.firstElement;
+                const int count = path.elementCount;
+                const auto fillRule = static_cast< Qt::FillRule >( path.fillRule );
+
+                cmds += QskPainterCommand(
+                    [ storage, pathElements, count, fillRule ]
+                    { return qskPath( pathElements, count, fillRule ); } );
+
                 break;
             }
             case QskPainterCommand::Pixmap:
+            case QskPainterCommand::Image:
             {
-                qskWritePixmapData( *cmds[ i ].pixmapData(), stream );
+                if ( command.index >= header->rasterCount )
+                    return QskGraphic();
+
+                const auto& raster = rasters[ command.index ];
+
+                if ( !isInBlob( raster.blobOffset, raster.blobSize ) )
+                    return QskGraphic();
+
+                const auto bytes = blob + raster.blobOffset;
+                const int bytesSize = raster.blobSize;
+
+                const auto rect = qskRect( raster.rect );
+                const auto subRect = qskRect( raster.subRect );
+
+                if ( command.type == QskPainterCommand::Pixmap )
+                {
+                    cmds += QskPainterCommand( rect,
+                        [ storage, bytes, bytesSize ]
+                        { return qskDecoded< QPixmap >( bytes, bytesSize ); },
+                        subRect );
+                }
+                else
+                {
+                    const auto flags = static_cast< Qt::ImageConversionFlags >(
+                        static_cast< int >( raster.flags ) );
+
+                    cmds += QskPainterCommand( rect,
+                        [ storage, bytes, bytesSize ]
+                        { return qskDecoded< QImage >( bytes, bytesSize ); },
+                        subRect, flags );
+                }
+
                 break;
             }
+            case QskPainterCommand::State:
+            {
+                if ( command.index >= header->stateCount )
+                    return QskGraphic();
+
+                const auto& state = states[ command.index ];
+
+                if ( state.blobSize > 0 )
+                {
+                    if ( !isInBlob( state.blobOffset, state.blobSize ) )
+                        return QskGraphic();
+
+                    const auto bytes = QByteArray::fromRawData(
+                        blob + state.blobOffset, state.blobSize );
+
+                    QDataStream stream( bytes );
+                    stream.setVersion( qskDataStreamVersion );
+                    stream.setByteOrder( QDataStream::BigEndian );
+
+                    qskReadStateData( stream, cmds );
+                }
+                else
+                {
+                    cmds += QskPainterCommand( qskStateData( state ) );
+                }
+
+                break;
+            }
+            default:
+                return QskGraphic();
+        }
+    }
+
+    QVector< Graphic::PathGeometry > geometries;
+    geometries.reserve( header->pathGeometryCount );
+
+    for ( quint32 i = 0; i < header->pathGeometryCount; i++ )
+    {
+        const auto& g = pathGeometries[ i ];
+
+        Graphic::PathGeometry geometry;
+        geometry.pointRect = qskRect( g.pointRect );
+        geometry.boundingRect = qskRect( g.boundingRect );
+        geometry.scalablePen = g.scalablePen;
+
+        geometries += geometry;
+    }
+
+    QskGraphicIOPrivate::Graphic graphic;
+    graphic.setCommands( cmds,
+        static_cast< QskGraphic::CommandTypes >( static_cast< int >( header->commandTypes ) ),
+        qskRect( header->boundingRect ), qskRect( header->pointRect ), geometries );
+
+    return graphic;
+}
+
+static QskGraphic qskReadFlat( const char* data, qint64 size,
+    const std::shared_ptr< const void >& storage )
+{
+    using namespace QskGraphicIOPrivate;
+
+    bool isSwapped = false;
+
+    if ( size >= qint64( sizeof( Header ) ) )
+    {
+        quint16 byteOrder;
+        memcpy( &byteOrder, data + offsetof( Header, byteOrder ), sizeof( byteOrder ) );
+
+        isSwapped = ( byteOrder != qskByteOrderMark );
+    }
+
+    if ( isSwapped || ( reinterpret_cast< quintptr >( data ) % 8 ) )
+    {
+        // f.e. compressed resources or big endian systems
+        const auto bytes = std::make_shared< QByteArray >( data, int( size ) );
+
+        if ( isSwapped && !qskSwapFlat( bytes->data(), size ) )
+        {
+            qWarning( "QskGraphicIO::read: invalid data" );
+            return QskGraphic();
+        }
+
+        return qskReadFlatAligned( bytes->constData(), size, bytes );
+    }
+
+    return qskReadFlatAligned( data, size, storage );
+}
+
+static bool qskWriteFlat( const QskGraphic& graphic, QIODevice* dev )
+{
+    using namespace QskGraphicIOPrivate;
+
+    QVector< Command > commands;
+    QVector< Path > paths;
+    QVector< PathElement > elements;
+    QVector< State > states;
+    QVector< Raster > rasters;
+    QByteArray blob;
+
+    commands.reserve( graphic.commands().size() );
+
+    for ( const auto& cmd : graphic.commands() )
+    {
+        Command command;
+        command.type = cmd.type();
+
+        switch ( cmd.type() )
+        {
+            case QskPainterCommand::Path:
+            {
+                const auto& painterPath = *cmd.path();
+
+                Path path;
+                path.firstElement = elements.size();
+                path.elementCount = painterPath.elementCount();
+                path.fillRule = painterPath.fillRule();
+                path.reserved = 0;
+
+                for ( int i = 0; i < painterPath.elementCount(); i++ )
+                {
+                    const auto e = painterPath.elementAt( i );
+                    elements += PathElement { e.x, e.y, static_cast< qint32 >( e.type ), 0 };
+                }
+
+                command.index = paths.size();
+                paths += path;
+
+                break;
+            }
+            case QskPainterCommand::Pixmap:
             case QskPainterCommand::Image:
             {
-                qskWriteImageData( *cmds[ i ].imageData(), stream );
+                Raster raster;
+                memset( &raster, 0, sizeof( raster ) );
+
+                if ( cmd.type() == QskPainterCommand::Pixmap )
+                {
+                    const auto data = cmd.pixmapData();
+
+                    qskFlatRect( data->rect, raster.rect );
+                    qskFlatRect( data->subRect, raster.subRect );
+
+                    qskAppendBlob( blob, raster.blobOffset, raster.blobSize,
+                        [ data ]( QDataStream& s ) { s << data->pixmap; } );
+                }
+                else
+                {
+                    const auto data = cmd.imageData();
+
+                    qskFlatRect( data->rect, raster.rect );
+                    qskFlatRect( data->subRect, raster.subRect );
+                    raster.flags = static_cast< int >( data->flags );
+
+                    qskAppendBlob( blob, raster.blobOffset, raster.blobSize,
+                        [ data ]( QDataStream& s ) { s << data->image; } );
+                }
+
+                command.index = rasters.size();
+                rasters += raster;
+
                 break;
             }
             case QskPainterCommand::State:
             {
-                qskWriteStateData( *cmds[ i ].stateData(), stream );
+                const auto data = cmd.stateData();
+
+                State state;
+
+                if ( qskIsFlatState( *data ) )
+                {
+                    state = qskFlatState( *data );
+                }
+                else
+                {
+                    memset( &state, 0, sizeof( state ) );
+                    state.flags = data->flags;
+
+                    qskAppendBlob( blob, state.blobOffset, state.blobSize,
+                        [ data ]( QDataStream& s ) { qskWriteStateData( *data, s ); } );
+                }
+
+                command.index = states.size();
+                states += state;
+
                 break;
             }
             default:
             {
-                // cleanup ???
                 return false;
             }
         }
+
+        commands += command;
     }
 
-    return true;
+    Header header;
+    memset( &header, 0, sizeof( header ) );
+
+    memcpy( header.magic, qskMagicNumberFlat, 4 );
+    header.version = qskFlatVersion;
+    header.byteOrder = qskByteOrderMark;
+
+    header.commandTypes = static_cast< int >( graphic.commandTypes() );
+    header.commandCount = commands.size();
+    header.pathCount = paths.size();
+    header.elementCount = elements.size();
+    header.stateCount = states.size();
+    header.rasterCount = rasters.size();
+    header.blobSize = blob.size();
+
+    /*
+        Writing is usually done offline, where we can afford
+        creating the strokes for the exact geometries. The bounding
+        rectangle is calculated in the same way, so that it is
+        consistent with the geometries of the paths.
+     */
+
+    QVector< PathGeometry > pathGeometries;
+
+    {
+        Graphic g;
+        static_cast< QskGraphic& >( g ) = graphic;
+
+        QRectF boundingRect;
+        const auto geometries = g.exactPathGeometries( &boundingRect );
+
+        pathGeometries.reserve( geometries.size() );
+
+        for ( const auto& geometry : geometries )
+        {
+            PathGeometry pathGeometry;
+            memset( &pathGeometry, 0, sizeof( pathGeometry ) );
+
+            qskFlatRect( geometry.pointRect, pathGeometry.pointRect );
+            qskFlatRect( geometry.boundingRect, pathGeometry.boundingRect );
+            pathGeometry.scalablePen = geometry.scalablePen;
+
+            pathGeometries += pathGeometry;
+        }
+
+        header.pathGeometryCount = pathGeometries.size();
+        qskFlatRect( boundingRect, header.boundingRect );
+    }
+
+    qskFlatRect( graphic.controlPointRect(), header.pointRect );
+
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    qskSwapRecord( header );
+
+    qskSwapRecords( commands );
+    qskSwapRecords( paths );
+    qskSwapRecords( elements );
+    qskSwapRecords( states );
+    qskSwapRecords( rasters );
+    qskSwapRecords( pathGeometries );
+#endif
+
+    const auto writeSection = [ dev ]( const void* data, qint64 size )
+    {
+        return ( size == 0 ) ||
+            ( dev->write( static_cast< const char* >( data ), size ) == size );
+    };
+
+    return writeSection( &header, sizeof( header ) )
+        && writeSection( commands.constData(), commands.size() * sizeof( Command ) )
+        && writeSection( paths.constData(), paths.size() * sizeof( Path ) )
+        && writeSection( elements.constData(), elements.size() * sizeof( PathElement ) )
+        && writeSection( states.constData(), states.size() * sizeof( State ) )
+        && writeSection( rasters.constData(), rasters.size() * sizeof( Raster ) )
+        && writeSection( pathGeometries.constData(),
+            pathGeometries.size() * sizeof( PathGeometry ) )
+        && writeSection( blob.constData(), blob.size() );
+}
+
+QskGraphic QskGraphicIO::read( const QString& fileName )
+{
+    const auto file = std::make_shared< QFile >( fileName );
+    if ( file->open( QIODevice::ReadOnly ) == false )
+    {
+        qWarning( "QskGraphicIO::read can't open %s", qPrintable( fileName ) );
+        return QskGraphic();
+    }
+
+    const auto magicNumber = file->peek( 4 );
+
+    if ( qskIsFlat( magicNumber.constData(), magicNumber.size() ) )
+    {
+        const auto size = file->size();
+
+        if ( const auto data = file->map( 0, size ) )
+        {
+            /*
+                The mapping stays valid until the QFile object gets
+                destroyed, what happens, when the last command
+                referring to it is gone.
+             */
+            file->close();
+
+            return qskReadFlat( reinterpret_cast< const char* >( data ), size, file );
+        }
+    }
+
+    return read( file.get() );
+}
+
+QskGraphic QskGraphicIO::read( const QByteArray& data )
+{
+    if ( qskIsFlat( data.constData(), data.size() ) )
+    {
+        // a shallow copy, that keeps the data alive
+        const auto bytes = std::make_shared< QByteArray >( data );
+        return qskReadFlat( bytes->constData(), bytes->size(), bytes );
+    }
+
+    QBuffer buffer;
+    buffer.setData( data );
+    buffer.open( QIODevice::ReadOnly );
+
+    return qskReadStream( &buffer );
+}
+
+QskGraphic QskGraphicIO::read( QIODevice* dev )
+{
+    if ( dev == nullptr )
+        return QskGraphic();
+
+    const auto magicNumber = dev->peek( 4 );
+
+    if ( qskIsFlat( magicNumber.constData(), magicNumber.size() ) )
+        return read( dev->readAll() );
+
+    return qskReadStream( dev );
+}
+
+QskGraphic QskGraphicIO::read( const char* data, qint64 size,
+    const std::shared_ptr< const void >& storage )
+{
+    if ( data == nullptr )
+        return QskGraphic();
+
+    if ( qskIsFlat( data, size ) )
+        return qskReadFlat( data, size, storage );
+
+    QBuffer buffer;
+    buffer.setData( QByteArray::fromRawData( data, int( size ) ) );
+    buffer.open( QIODevice::ReadOnly );
+
+    return qskReadStream( &buffer );
+}
+
+bool QskGraphicIO::write( const QskGraphic& graphic, const QString& fileName )
+{
+    QFile file( fileName );
+    if ( file.open( QIODevice::WriteOnly | QIODevice::Truncate ) == false )
+    {
+        qWarning( "QskGraphicIO::write can't open %s", qPrintable( fileName ) );
+        return false;
+    }
+
+    return write( graphic, &file );
+}
+
+bool QskGraphicIO::write( const QskGraphic& graphic, QByteArray& data )
+{
+    QBuffer buffer( &data );
+    buffer.open( QIODevice::WriteOnly );
+
+    return write( graphic, &buffer );
+}
+
+bool QskGraphicIO::write( const QskGraphic& graphic, QIODevice* dev )
+{
+    if ( dev == nullptr )
+        return false;
+
+    return qskWriteFlat( graphic, dev );
 }
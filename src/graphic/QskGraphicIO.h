@@ -7,6 +7,7 @@
 #define QSK_GRAPHIC_IO_H
 
 #include "QskGlobal.h"
+#include <memory>
 
 class QskGraphic;
 class QString;
@@ -19,6 +20,13 @@ namespace QskGraphicIO
     QSK_EXPORT QskGraphic read( const QByteArray& data );
     QSK_EXPORT QskGraphic read( QIODevice* dev );
 
+    /*
+        Reading from memory, that is kept alive by storage as long
+        as the graphic refers to it ( f.e. a memory mapped file )
+     */
+    QSK_EXPORT QskGraphic read( const char* data, qint64 size,
+        const std::shared_ptr< const void >& storage );
+
     QSK_EXPORT bool write( const QskGraphic&, const QString& fileName );
     QSK_EXPORT bool write( const QskGraphic&, QByteArray& data );
     QSK_EXPORT bool write( const QskGraphic&, QIODevice* dev );
@@ -8,6 +8,19 @@
 #include "QskGraphicProvider.h"
 #include "QskGraphicTextureFactory.h"
 
+// stripping the "?mipmap" parameter from the id
+static inline QString qskGraphicId( const QString& id, bool* mipmapped = nullptr )
+{
+    static const QLatin1String suffix( "?mipmap" );
+
+    const bool on = id.endsWith( suffix );
+
+    if ( mipmapped )
+        *mipmapped = on;
+
+    return on ? id.left( id.length() - suffix.size() ) : id;
+}
+
 static inline QSize qskGraphicSize( const QskGraphic& graphic,
     const QSize& requestedSize, QSize* result )
 {
@@ -63,8 +76,6 @@ QString QskGraphicImageProvider::graphicProviderId() const
 QImage QskGraphicImageProvider::requestImage(
     const QString& id, QSize* size, const QSize& requestedSize )
 {
-    // mutex ???
-
     if ( requestedSize.width() == 0 || requestedSize.height() == 0 )
     {
         // during startup QML layouts need some time to find its
@@ -75,12 +86,12 @@ QImage QskGraphicImageProvider::requestImage(
         return dummy;
     }
 
-    const auto graphic = requestGraphic( id );
-    if ( graphic == nullptr )
+    const auto graphic = requestGraphic( qskGraphicId( id ) );
+    if ( graphic.isNull() )
         return QImage();
 
-    const QSize sz = qskGraphicSize( *graphic, requestedSize, size );
-    return graphic->toImage( sz, Qt::KeepAspectRatio );
+    const QSize sz = qskGraphicSize( graphic, requestedSize, size );
+    return graphic.toImage( sz, Qt::KeepAspectRatio );
 }
 
 QPixmap QskGraphicImageProvider::requestPixmap(
@@ -96,12 +107,12 @@ QPixmap QskGraphicImageProvider::requestPixmap(
         return dummy;
     }
 
-    const auto graphic = requestGraphic( id );
-    if ( graphic == nullptr )
+    const auto graphic = requestGraphic( qskGraphicId( id ) );
+    if ( graphic.isNull() )
         return QPixmap();
 
-    const QSize sz = qskGraphicSize( *graphic, requestedSize, size );
-    return graphic->toPixmap( sz, Qt::KeepAspectRatio );
+    const QSize sz = qskGraphicSize( graphic, requestedSize, size );
+    return graphic.toPixmap( sz, Qt::KeepAspectRatio );
 }
 
 QQuickTextureFactory* QskGraphicImageProvider::requestTexture(
@@ -110,18 +121,24 @@ QQuickTextureFactory* QskGraphicImageProvider::requestTexture(
     if ( requestedSize.width() == 0 || requestedSize.height() == 0 )
         return nullptr;
 
-    const auto graphic = requestGraphic( id );
-    if ( graphic == nullptr )
+    bool mipmapped;
+
+    const auto graphic = requestGraphic( qskGraphicId( id, &mipmapped ) );
+    if ( graphic.isNull() )
         return nullptr;
 
-    const QSize sz = qskGraphicSize( *graphic, requestedSize, size );
-    return new QskGraphicTextureFactory( *graphic, sz );
+    const QSize sz = qskGraphicSize( graphic, requestedSize, size );
+
+    auto factory = new QskGraphicTextureFactory( graphic, sz );
+    factory->setMipmapped( mipmapped );
+
+    return factory;
 }
 
-const QskGraphic* QskGraphicImageProvider::requestGraphic( const QString& id ) const
+QskGraphic QskGraphicImageProvider::requestGraphic( const QString& id ) const
 {
     if ( auto graphicProvider = Qsk::graphicProvider( m_providerId ) )
-        return graphicProvider->requestGraphic( id );
+        return graphicProvider->graphic( id );
 
-    return nullptr;
+    return QskGraphic();
 }
@@ -11,6 +11,11 @@
 
 class QskGraphic;
 
+/*
+    Appending "?mipmap" to the id of a texture request creates
+    a mipmapped texture: "image://provider/id?mipmap". This is
+    recommended for images, that are scaled down a lot.
+ */
 class QSK_EXPORT QskGraphicImageProvider : public QQuickImageProvider
 {
   public:
@@ -29,7 +34,7 @@ class QSK_EXPORT QskGraphicImageProvider : public QQuickImageProvider
     QString graphicProviderId() const;
 
   protected:
-    const QskGraphic* requestGraphic( const QString& id ) const;
+    QskGraphic requestGraphic( const QString& id ) const;
 
   private:
     Q_DISABLE_COPY( QskGraphicImageProvider )
@@ -0,0 +1,416 @@
+/******************************************************************************
+ * QSkinny - Copyright (C) 2016 Uwe Rathmann
+ * This file may be used under the terms of the QSkinny License, Version 1.0
+ *****************************************************************************/
+
+#include "QskGraphicOptimizer.h"
+#include "QskGraphic.h"
+#include "QskPainterCommand.h"
+
+#include <qvector.h>
+
+/*
+    To avoid subobject-linkage warnings, when including the source code in
+    svg2qvg we don't use an anonymous namespace here
+ */
+namespace QskGraphicOptimizerPrivate
+{
+    typedef QskPainterCommand::StateData StateData;
+
+    const QPaintEngine::DirtyFlags clipFlags = QPaintEngine::DirtyClipEnabled
+        | QPaintEngine::DirtyClipRegion | QPaintEngine::DirtyClipPath;
+
+    // all flags, that are respected when replaying a graphic - beside the clip
+    const QPaintEngine::DirtyFlag stateFlags[] =
+    {
+        QPaintEngine::DirtyPen,
+        QPaintEngine::DirtyBrush,
+        QPaintEngine::DirtyBrushOrigin,
+        QPaintEngine::DirtyFont,
+        QPaintEngine::DirtyBackground,
+        QPaintEngine::DirtyTransform,
+        QPaintEngine::DirtyHints,
+        QPaintEngine::DirtyCompositionMode,
+        QPaintEngine::DirtyOpacity
+    };
+
+    class Optimizer
+    {
+      public:
+        Optimizer( QskGraphicOptimizer::Optimizations );
+
+        void addState( const StateData& );
+        void addPath( const QPainterPath& );
+        void addRaster( const QskPainterCommand& );
+
+        QVector< QskPainterCommand > commands();
+
+      private:
+        void append( const QskPainterCommand& );
+        void flush( bool foldTransform );
+        void flushPath();
+
+        bool canFold() const;
+        bool mergeRect( const QPainterPath&, QRectF& ) const;
+
+        const QskGraphicOptimizer::Optimizations m_optimizations;
+
+        QVector< QskPainterCommand > m_commands;
+
+        // the state as it has been recorded
+        StateData m_logical;
+        QPaintEngine::DirtyFlags m_logicalFlags;
+        QPaintEngine::DirtyFlags m_dirtyFlags;
+
+        // the state as it is set, when replaying the optimized commands
+        StateData m_emitted;
+        QPaintEngine::DirtyFlags m_emittedFlags;
+
+        // a path, that might be extended by the following paths
+        QPainterPath m_path;
+        QRectF m_pathRect;
+        bool m_hasPath = false;
+    };
+}
+
+using namespace QskGraphicOptimizerPrivate;
+
+static void qskCopyState( const StateData& from,
+    QPaintEngine::DirtyFlags flags, StateData& to )
+{
+    if ( flags & QPaintEngine::DirtyPen )
+        to.pen = from.pen;
+
+    if ( flags & QPaintEngine::DirtyBrush )
+        to.brush = from.brush;
+
+    if ( flags & QPaintEngine::DirtyBrushOrigin )
+        to.brushOrigin = from.brushOrigin;
+
+    if ( flags & QPaintEngine::DirtyFont )
+        to.font = from.font;
+
+    if ( flags & QPaintEngine::DirtyBackground )
+    {
+        to.backgroundMode = from.backgroundMode;
+        to.backgroundBrush = from.backgroundBrush;
+    }
+
+    if ( flags & QPaintEngine::DirtyTransform )
+        to.transform = from.transform;
+
+    if ( flags & QPaintEngine::DirtyClipEnabled )
+        to.isClipEnabled = from.isClipEnabled;
+
+    if ( flags & QPaintEngine::DirtyClipRegion )
+    {
+        to.clipRegion = from.clipRegion;
+        to.clipOperation = from.clipOperation;
+    }
+
+    if ( flags & QPaintEngine::DirtyClipPath )
+    {
+        to.clipPath = from.clipPath;
+        to.clipOperation = from.clipOperation;
+    }
+
+    if ( flags & QPaintEngine::DirtyHints )
+        to.renderHints = from.renderHints;
+
+    if ( flags & QPaintEngine::DirtyCompositionMode )
+        to.compositionMode = from.compositionMode;
+
+    if ( flags & QPaintEngine::DirtyOpacity )
+        to.opacity = from.opacity;
+}
+
+static bool qskIsEqual( const StateData& s1,
+    const StateData& s2, QPaintEngine::DirtyFlag flag )
+{
+    switch ( flag )
+    {
+        case QPaintEngine::DirtyPen:
+            return s1.pen == s2.pen;
+
+        case QPaintEngine::DirtyBrush:
+            return s1.brush == s2.brush;
+
+        case QPaintEngine::DirtyBrushOrigin:
+            return s1.brushOrigin == s2.brushOrigin;
+
+        case QPaintEngine::DirtyFont:
+            return s1.font == s2.font;
+
+        case QPaintEngine::DirtyBackground:
+            return ( s1.backgroundMode == s2.backgroundMode )
+                && ( s1.backgroundBrush == s2.backgroundBrush );
+
+        case QPaintEngine::DirtyTransform:
+            return s1.transform == s2.transform;
+
+        case QPaintEngine::DirtyHints:
+            return s1.renderHints == s2.renderHints;
+
+        case QPaintEngine::DirtyCompositionMode:
+            return s1.compositionMode == s2.compositionMode;
+
+        case QPaintEngine::DirtyOpacity:
+            return s1.opacity == s2.opacity;
+
+        default:
+            return false;
+    }
+}
+
+static inline bool qskHasPen( const QPen& pen )
+{
+    return ( pen.style() != Qt::NoPen ) && ( pen.brush().style() != Qt::NoBrush );
+}
+
+static inline bool qskOverlaps( const QRectF& r1, const QRectF& r2 )
+{
+    // QRectF::intersects is always false for rectangles without width or height
+
+    return ( r1.left() <= r2.right() ) && ( r2.left() <= r1.right() )
+        && ( r1.top() <= r2.bottom() ) && ( r2.top() <= r1.bottom() );
+}
+
+static inline QRectF qskUnited( const QRectF& r1, const QRectF& r2 )
+{
+    // QRectF::united ignores rectangles without width or height
+
+    const auto left = qMin( r1.left(), r2.left() );
+    const auto top = qMin( r1.top(), r2.top() );
+    const auto right = qMax( r1.right(), r2.right() );
+    const auto bottom = qMax( r1.bottom(), r2.bottom() );
+
+    return QRectF( left, top, right - left, bottom - top );
+}
+
+Optimizer::Optimizer( QskGraphicOptimizer::Optimizations optimizations )
+    : m_optimizations( optimizations )
+{
+    m_logical.flags = m_emitted.flags = QPaintEngine::DirtyFlags();
+}
+
+void Optimizer::addState( const StateData& state )
+{
+    QPaintEngine::DirtyFlags flags;
+    for ( const auto flag : stateFlags )
+    {
+        if ( state.flags & flag )
+            flags |= flag;
+    }
+
+    qskCopyState( state, flags, m_logical );
+
+    m_logicalFlags |= flags;
+    m_dirtyFlags |= flags;
+
+    if ( state.flags & clipFlags )
+    {
+        /*
+            The clip is mapped by the transformation, that is
+            active when setting it. So we can't delay it.
+         */
+        flush( false );
+
+        StateData clipState;
+        clipState.flags = state.flags & clipFlags;
+        qskCopyState( state, clipState.flags, clipState );
+
+        append( QskPainterCommand( clipState ) );
+    }
+}
+
+void Optimizer::addPath( const QPainterPath& path )
+{
+    if ( path.isEmpty() )
+        return; // nothing to draw
+
+    const bool fold = canFold();
+
+    flush( fold );
+
+    const auto mappedPath = fold ? m_logical.transform.map( path ) : path;
+
+    /*
+        Overlapping parts would be painted only once - what makes a
+        difference for transparent colors, the fill rule or composition
+        modes. Paths, that are far enough apart, can be painted at once.
+     */
+
+    QRectF pathRect;
+    const bool mergeable = mergeRect( mappedPath, pathRect );
+
+    if ( m_hasPath && mergeable
+        && ( mappedPath.fillRule() == m_path.fillRule() )
+        && !qskOverlaps( pathRect, m_pathRect ) )
+    {
+        m_path.addPath( mappedPath );
+        m_pathRect = qskUnited( m_pathRect, pathRect );
+    }
+    else
+    {
+        flushPath();
+
+        m_path = mappedPath;
+        m_pathRect = pathRect;
+        m_hasPath = true;
+    }
+}
+
+void Optimizer::addRaster( const QskPainterCommand& command )
+{
+    flush( false );
+    append( command );
+}
+
+QVector< QskPainterCommand > Optimizer::commands()
+{
+    /*
+        Trailing state changes have no effect and are dropped,
+        as the painter gets restored after rendering the graphic.
+     */
+    flushPath();
+    return m_commands;
+}
+
+void Optimizer::append( const QskPainterCommand& command )
+{
+    flushPath();
+    m_commands += command;
+}
+
+void Optimizer::flushPath()
+{
+    if ( m_hasPath )
+    {
+        m_commands += QskPainterCommand( m_path );
+
+        m_path = QPainterPath();
+        m_hasPath = false;
+    }
+}
+
+void Optimizer::flush( bool foldTransform )
+{
+    const bool removeRedundant =
+        m_optimizations & QskGraphicOptimizer::RemoveRedundantStates;
+
+    StateData wanted = m_logical;
+    if ( foldTransform )
+        wanted.transform = QTransform();
+
+    StateData state;
+    state.flags = QPaintEngine::DirtyFlags();
+
+    for ( const auto flag : stateFlags )
+    {
+        if ( !( m_logicalFlags & flag ) )
+            continue;
+
+        const bool needed = !( m_emittedFlags & flag )
+            || !qskIsEqual( wanted, m_emitted, flag )
+            || ( !removeRedundant && ( m_dirtyFlags & flag ) );
+
+        if ( needed )
+            state.flags |= flag;
+    }
+
+    m_dirtyFlags = QPaintEngine::DirtyFlags();
+
+    if ( state.flags )
+    {
+        qskCopyState( wanted, state.flags, state );
+        append( QskPainterCommand( state ) );
+
+        qskCopyState( wanted, state.flags, m_emitted );
+        m_emittedFlags |= state.flags;
+    }
+}
+
+bool Optimizer::canFold() const
+{
+    if ( !( m_optimizations & QskGraphicOptimizer::FoldTransformations ) )
+        return false;
+
+    const QPaintEngine::DirtyFlags flags = QPaintEngine::DirtyTransform
+        | QPaintEngine::DirtyPen | QPaintEngine::DirtyBrush;
+
+    if ( ( m_logicalFlags & flags ) != flags )
+        return false;
+
+    if ( m_logical.transform.isIdentity() || qskHasPen( m_logical.pen ) )
+        return false;
+
+    /*
+        The geometry of other brushes and of the pen depends on the
+        transformation, but a filled path without outline can be mapped.
+     */
+    const auto style = m_logical.brush.style();
+    return ( style == Qt::NoBrush ) || ( style == Qt::SolidPattern );
+}
+
+bool Optimizer::mergeRect( const QPainterPath& path, QRectF& rect ) const
+{
+    if ( !( m_optimizations & QskGraphicOptimizer::MergePaths ) )
+        return false;
+
+    if ( !( m_emittedFlags & QPaintEngine::DirtyPen ) )
+        return false;
+
+    qreal margin = 0.0;
+
+    const auto& pen = m_emitted.pen;
+    if ( qskHasPen( pen ) )
+    {
+        if ( pen.isCosmetic() )
+            return false; // we don't know the width in path coordinates
+
+        // miter joins might extend the outline to miterLimit * width / 2
+        margin = pen.widthF() * qMax( pen.miterLimit(), qreal( 1.0 ) );
+    }
+
+    rect = path.controlPointRect().adjusted( -margin, -margin, margin, margin );
+    return true;
+}
+
+QskGraphic QskGraphicOptimizer::optimized(
+    const QskGraphic& graphic, Optimizations optimizations )
+{
+    if ( graphic.isNull() || optimizations == Optimizations() )
+        return graphic;
+
+    Optimizer optimizer( optimizations );
+
+    for ( const auto& command : graphic.commands() )
+    {
+        switch ( command.type() )
+        {
+            case QskPainterCommand::Path:
+                optimizer.addPath( *command.path() );
+                break;
+
+            case QskPainterCommand::Pixmap:
+            case QskPainterCommand::Image:
+                optimizer.addRaster( command );
+                break;
+
+            case QskPainterCommand::State:
+                optimizer.addState( *command.stateData() );
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    QskGraphic optimizedGraphic;
+    optimizedGraphic.setCommands( optimizer.commands() );
+    optimizedGraphic.setDefaultSize( graphic.defaultSize() );
+    optimizedGraphic.setRenderHint( QskGraphic::RenderPensUnscaled,
+        graphic.testRenderHint( QskGraphic::RenderPensUnscaled ) );
+
+    return optimizedGraphic;
+}
@@ -0,0 +1,46 @@
+/******************************************************************************
+ * QSkinny - Copyright (C) 2016 Uwe Rathmann
+ * This file may be used under the terms of the QSkinny License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QSK_GRAPHIC_OPTIMIZER_H
+#define QSK_GRAPHIC_OPTIMIZER_H
+
+#include "QskGlobal.h"
+#include <qflags.h>
+
+class QskGraphic;
+
+/*
+    Graphics recorded from SVGs often contain long runs of state changes,
+    that have no effect on the result. The optimizer creates a graphic,
+    that renders the same output with less commands.
+
+    As all commands have to be evaluated this is intended for
+    tools like svg2qvg and not for loading graphics at runtime.
+ */
+namespace QskGraphicOptimizer
+{
+    enum Optimization
+    {
+        // drop state changes, that are overwritten or do not change anything
+        RemoveRedundantStates = 1 << 0,
+
+        // map paths filled without pen and with solid brushes to the identity
+        FoldTransformations = 1 << 1,
+
+        // join adjacent paths with the same state, that do not overlap
+        MergePaths = 1 << 2,
+
+        AllOptimizations = RemoveRedundantStates | FoldTransformations | MergePaths
+    };
+
+    typedef QFlags< Optimization > Optimizations;
+
+    QSK_EXPORT QskGraphic optimized( const QskGraphic&,
+        Optimizations = AllOptimizations );
+}
+
+Q_DECLARE_OPERATORS_FOR_FLAGS( QskGraphicOptimizer::Optimizations )
+
+#endif
@@ -5,19 +5,94 @@
 
 #include "QskGraphicProvider.h"
 #include "QskGraphic.h"
+#include "QskPainterCommand.h"
 #include "QskSetup.h"
 
+#include <qatomic.h>
 #include <qmutex.h>
 #include <qcache.h>
+#include <qcoreapplication.h>
 #include <qdebug.h>
+#include <qpair.h>
+#include <qpointer.h>
+#include <qstringlist.h>
+#include <qthreadpool.h>
 #include <qurl.h>
 
+#include <limits>
+
+namespace
+{
+    /*
+        One cache for all providers, so that the memory budget
+        is not multiplied by the number of providers
+     */
+    class GraphicCache
+    {
+      public:
+        typedef QPair< const QskGraphicProvider*, QString > Key;
+
+        GraphicCache()
+        {
+            cache.setMaxCost( 16 * 1024 * 1024 );
+        }
+
+        QMutex mutex;
+        QCache< Key, const QskGraphic > cache;
+    };
+}
+
+Q_GLOBAL_STATIC( GraphicCache, qskGraphicCache )
+
+static inline qint64 qskPathCost( const QPainterPath& path )
+{
+    return sizeof( QPainterPath )
+        + path.elementCount() * qint64( sizeof( QPainterPath::Element ) );
+}
+
+static inline QString qskImageId( const QUrl& url )
+{
+    auto imageId = url.toString( QUrl::RemoveScheme |
+        QUrl::RemoveAuthority | QUrl::NormalizePathSegments );
+
+    if ( !imageId.isEmpty() && imageId[ 0 ] == '/' )
+        imageId = imageId.mid( 1 );
+
+    return imageId;
+}
+
 class QskGraphicProvider::PrivateData
 {
   public:
-    // caching of graphics
-    QCache< QString, const QskGraphic > cache;
-    QMutex mutex;
+    PrivateData()
+        : alive( 1 )
+    {
+        prefetchPool.setMaxThreadCount( 1 );
+    }
+
+    void startJob( const std::function< void() >& job )
+    {
+        prefetchPool.start(
+            [ this, job ]()
+            {
+                /*
+                    runningJobs is incremented before checking alive, so that
+                    the destructor either sees the job or the job sees, that
+                    the provider is being destroyed.
+                 */
+                runningJobs.ref();
+
+                if ( alive.loadAcquire() )
+                    job();
+
+                runningJobs.deref();
+            } );
+    }
+
+    QThreadPool prefetchPool;
+
+    QAtomicInt runningJobs;
+    QAtomicInt alive;
 };
 
 QskGraphicProvider::QskGraphicProvider( QObject* parent )
@@ -28,6 +103,20 @@ QskGraphicProvider::QskGraphicProvider( QObject* parent )
 
 QskGraphicProvider::~QskGraphicProvider()
 {
+    /*
+        The jobs of the prefetch pool end up in loadGraphic, that
+        is pure virtual once the destructor of the derived class has
+        been passed. Jobs, that have not started yet, are skipped,
+        but a running job means, that the derived class did not
+        call cancelPrefetch() in its destructor.
+     */
+    m_data->alive.fetchAndStoreOrdered( 0 );
+
+    Q_ASSERT_X( m_data->runningJobs.loadAcquire() == 0, "~QskGraphicProvider",
+        "derived classes have to call cancelPrefetch() in their destructor" );
+
+    cancelPrefetch();
+    clearCache();
 }
 
 void QskGraphicProvider::setCacheSize( int size )
@@ -35,60 +124,236 @@ void QskGraphicProvider::setCacheSize( int size )
     if ( size < 0 )
         size = 0;
 
-    QMutexLocker locker( &m_data->mutex );
-    m_data->cache.setMaxCost( size );
+    auto graphicCache = qskGraphicCache;
+
+    QMutexLocker locker( &graphicCache->mutex );
+    graphicCache->cache.setMaxCost( size );
 }
 
-int QskGraphicProvider::cacheSize() const
+int QskGraphicProvider::cacheSize()
 {
-    QMutexLocker locker( &m_data->mutex );
-    return m_data->cache.maxCost();
+    auto graphicCache = qskGraphicCache;
+
+    QMutexLocker locker( &graphicCache->mutex );
+    return graphicCache->cache.maxCost();
 }
 
-void QskGraphicProvider::clearCache()
+int QskGraphicProvider::cacheCost()
 {
-    QMutexLocker locker( &m_data->mutex );
-    m_data->cache.clear();
+    auto graphicCache = qskGraphicCache;
+
+    QMutexLocker locker( &graphicCache->mutex );
+    return graphicCache->cache.totalCost();
 }
 
-const QskGraphic* QskGraphicProvider::requestGraphic( const QString& id ) const
+int QskGraphicProvider::graphicCost( const QskGraphic& graphic )
 {
-    const QskGraphic* graphic = nullptr;
+    /*
+        A rough estimate of the memory being used by a graphic.
+        Payloads of deferred commands are usually in memory
+        mapped files and are not taken into account.
+     */
 
-    {
-        QMutexLocker locker( &m_data->mutex );
-        graphic = m_data->cache.object( id );
-    }
+    qint64 cost = sizeof( QskGraphic );
 
-    if ( graphic == nullptr )
+    const auto commands = graphic.commands();
+
+    for ( const auto& command : commands )
     {
-        graphic = loadGraphic( id );
+        cost += sizeof( QskPainterCommand );
 
-        if ( graphic == nullptr )
-        {
-            qWarning() << "QskGraphicProvider: can't load" << id;
-            return nullptr;
-        }
+        if ( command.isDeferred() )
+            continue;
 
+        switch ( command.type() )
         {
-            QMutexLocker locker( &m_data->mutex );
+            case QskPainterCommand::Path:
+            {
+                // + the bounding rectangles of the path
+                cost += qskPathCost( *command.path() ) + 2 * sizeof( QRectF );
+                break;
+            }
+            case QskPainterCommand::Pixmap:
+            {
+                const auto& pixmap = command.pixmapData()->pixmap;
 
-            if( auto cached = m_data->cache.object( id ) )
+                cost += sizeof( QskPainterCommand::PixmapData )
+                    + qint64( pixmap.width() ) * pixmap.height() * pixmap.depth() / 8;
+                break;
+            }
+            case QskPainterCommand::Image:
             {
-                delete graphic;
-                graphic = cached;
+                const auto& image = command.imageData()->image;
+
+                cost += sizeof( QskPainterCommand::ImageData )
+                    + qint64( image.width() ) * image.height() * image.depth() / 8;
+                break;
             }
-            else
+            case QskPainterCommand::State:
             {
-                const int cost = 1; // TODO ...
-                m_data->cache.insert( id, graphic, cost );
+                const auto stateData = command.stateData();
+
+                cost += sizeof( QskPainterCommand::StateData );
+
+                if ( !stateData->clipPath.isEmpty() )
+                    cost += qskPathCost( stateData->clipPath );
+
+                break;
             }
+            default:
+                break;
         }
     }
 
+    return static_cast< int >( qMin( cost,
+        qint64( std::numeric_limits< int >::max() ) ) );
+}
+
+void QskGraphicProvider::clearCache()
+{
+    auto graphicCache = qskGraphicCache;
+    if ( graphicCache == nullptr ) // during application shutdown
+        return;
+
+    QMutexLocker locker( &graphicCache->mutex );
+
+    const auto keys = graphicCache->cache.keys();
+    for ( const auto& key : keys )
+    {
+        if ( key.first == this )
+            graphicCache->cache.remove( key );
+    }
+}
+
+const QskGraphic* QskGraphicProvider::requestGraphic( const QString& id ) const
+{
+    return cachedGraphic( id, nullptr );
+}
+
+QskGraphic QskGraphicProvider::graphic( const QString& id ) const
+{
+    QskGraphic graphic;
+    ( void ) cachedGraphic( id, &graphic );
+
+    return graphic;
+}
+
+const QskGraphic* QskGraphicProvider::cachedGraphic(
+    const QString& id, QskGraphic* copy ) const
+{
+    /*
+        Graphics might be removed from the cache by other threads
+        at any time. So the copy has to be made, while holding the mutex.
+     */
+
+    auto graphicCache = qskGraphicCache;
+
+    const GraphicCache::Key key( this, id );
+
+    {
+        QMutexLocker locker( &graphicCache->mutex );
+
+        if ( auto graphic = graphicCache->cache.object( key ) )
+        {
+            if ( copy )
+                *copy = *graphic;
+
+            return graphic;
+        }
+    }
+
+    const QskGraphic* graphic = loadGraphic( id );
+
+    if ( graphic == nullptr )
+    {
+        qWarning() << "QskGraphicProvider: can't load" << id;
+        return nullptr;
+    }
+
+    const auto cost = graphicCost( *graphic );
+
+    QMutexLocker locker( &graphicCache->mutex );
+
+    if ( auto cached = graphicCache->cache.object( key ) )
+    {
+        // loaded by another thread in between
+        delete graphic;
+        graphic = cached;
+
+        if ( copy )
+            *copy = *graphic;
+    }
+    else
+    {
+        if ( copy )
+            *copy = *graphic;
+
+        /*
+            QCache would delete graphics exceeding the limit
+            immediately. Instead we let them use the complete
+            budget, until being replaced by the next graphic.
+         */
+        const auto maxCost = graphicCache->cache.maxCost();
+
+        if ( !graphicCache->cache.insert( key, graphic, qMin( cost, maxCost ) ) )
+            graphic = nullptr; // deleted by QCache
+    }
+
     return graphic;
 }
 
+void QskGraphicProvider::prefetch( const QStringList& ids )
+{
+    auto graphicCache = qskGraphicCache;
+
+    for ( const auto& id : ids )
+    {
+        {
+            QMutexLocker locker( &graphicCache->mutex );
+            if ( graphicCache->cache.contains( GraphicCache::Key( this, id ) ) )
+                continue;
+        }
+
+        m_data->startJob( [ this, id ]() { ( void ) requestGraphic( id ); } );
+    }
+}
+
+void QskGraphicProvider::requestGraphicAsync( const QString& id,
+    const QObject* context, const std::function< void( const QskGraphic& ) >& callback )
+{
+    if ( context == nullptr || !callback )
+        return;
+
+    Q_ASSERT( context->thread() == QCoreApplication::instance()->thread() );
+
+    const QPointer< const QObject > guard( context );
+
+    m_data->startJob(
+        [ this, id, guard, callback ]()
+        {
+            const auto graphic = this->graphic( id );
+
+            /*
+                Posting to the context is not possible, as it might have
+                been deleted in between. So we post to the application
+                and check the guard, when being back in the GUI thread.
+             */
+            QMetaObject::invokeMethod( QCoreApplication::instance(),
+                [ guard, callback, graphic ]()
+                {
+                    if ( guard )
+                        callback( graphic );
+                },
+                Qt::QueuedConnection );
+        } );
+}
+
+void QskGraphicProvider::cancelPrefetch()
+{
+    m_data->prefetchPool.clear();
+    m_data->prefetchPool.waitForDone();
+}
+
 void Qsk::addGraphicProvider(
     const QString& providerId, QskGraphicProvider* provider )
 {
@@ -107,25 +372,30 @@ QskGraphic Qsk::loadGraphic( const char* source )
 
 QskGraphic Qsk::loadGraphic( const QUrl& url )
 {
-    static QskGraphic nullGraphic;
-
-    QString imageId = url.toString( QUrl::RemoveScheme |
-        QUrl::RemoveAuthority | QUrl::NormalizePathSegments );
-
+    const auto imageId = qskImageId( url );
     if ( imageId.isEmpty() )
-        return nullGraphic;
+        return QskGraphic();
 
-    if ( imageId[ 0 ] == '/' )
-        imageId = imageId.mid( 1 );
+    if ( const auto provider = qskSetup->graphicProvider( url.host() ) )
+        return provider->graphic( imageId );
 
-    const QString providerId = url.host();
+    return QskGraphic();
+}
 
-    const QskGraphic* graphic = nullptr;
+bool Qsk::loadGraphicAsync( const QUrl& url, const QObject* context,
+    const std::function< void( const QskGraphic& ) >& callback )
+{
+    const auto imageId = qskImageId( url );
+    if ( imageId.isEmpty() )
+        return false;
 
-    if ( const auto provider = qskSetup->graphicProvider( providerId ) )
-        graphic = provider->requestGraphic( imageId );
+    if ( const auto provider = qskSetup->graphicProvider( url.host() ) )
+    {
+        provider->requestGraphicAsync( imageId, context, callback );
+        return true;
+    }
 
-    return graphic ? *graphic : nullGraphic;
+    return false;
 }
 
 #include "moc_QskGraphicProvider.cpp"
@@ -9,10 +9,13 @@
 #include "QskGlobal.h"
 
 #include <qobject.h>
+
+#include <functional>
 #include <memory>
 
 class QskGraphic;
 class QUrl;
+class QStringList;
 
 class QSK_EXPORT QskGraphicProvider : public QObject
 {
@@ -24,18 +27,54 @@ class QSK_EXPORT QskGraphicProvider : public QObject
     QskGraphicProvider( QObject* parent = nullptr );
     ~QskGraphicProvider() override;
 
-    void setCacheSize( int );
-    int cacheSize() const;
+    /*
+        The cache is shared by all providers and its size is
+        the estimated memory ( in bytes ) of the cached graphics.
+     */
+    static void setCacheSize( int );
+    static int cacheSize();
+
+    static int cacheCost();
+    static int graphicCost( const QskGraphic& );
 
     void clearCache();
 
+    /*
+        The returned graphic is owned by the cache and might be deleted,
+        when other graphics are inserted - what might happen at any time,
+        when prefetch() or requestGraphicAsync() are in use.
+        graphic() returns a copy, that is always safe.
+     */
     const QskGraphic* requestGraphic( const QString& id ) const;
+    QskGraphic graphic( const QString& id ) const;
+
+    /*
+        Loading graphics into the cache in a worker thread. As loadGraphic
+        is then called from this thread the destructor of a derived
+        class has to call cancelPrefetch(): when the destructor of
+        QskGraphicProvider is running, loadGraphic can't be called anymore.
+        Pending jobs are skipped then, but a job still running at this
+        point is a bug of the derived class, that is reported by an assertion.
+     */
+    void prefetch( const QStringList& ids );
+    void cancelPrefetch();
+
+    /*
+        Loading a graphic in the prefetch thread. The callback is invoked
+        from the event loop of the GUI thread - unless the context object
+        has been deleted or the request has been canceled before.
+     */
+    void requestGraphicAsync( const QString& id, const QObject* context,
+        const std::function< void( const QskGraphic& ) >& );
 
   protected:
     virtual const QskGraphic* loadGraphic( const QString& id ) const = 0;
 
     class PrivateData;
     std::unique_ptr< PrivateData > m_data;
+
+  private:
+    const QskGraphic* cachedGraphic( const QString& id, QskGraphic* copy ) const;
 };
 
 namespace Qsk
@@ -45,6 +84,9 @@ namespace Qsk
 
     QSK_EXPORT QskGraphic loadGraphic( const QUrl& url );
     QSK_EXPORT QskGraphic loadGraphic( const char* source );
+
+    QSK_EXPORT bool loadGraphicAsync( const QUrl&, const QObject* context,
+        const std::function< void( const QskGraphic& ) >& );
 }
 
 #endif
@@ -7,6 +7,8 @@
 #include "QskTextureRenderer.h"
 
 #include <qquickwindow.h>
+#include <qimage.h>
+#include <qpainter.h>
 
 QskGraphicTextureFactory::QskGraphicTextureFactory()
 {
@@ -54,6 +56,16 @@ QSize QskGraphicTextureFactory::size() const
     return m_size;
 }
 
+void QskGraphicTextureFactory::setMipmapped( bool on )
+{
+    m_mipmapped = on;
+}
+
+bool QskGraphicTextureFactory::isMipmapped() const
+{
+    return m_mipmapped;
+}
+
 QSGTexture* QskGraphicTextureFactory::createTexture( QQuickWindow* window ) const
 {
     class PaintHelper : public QskTextureRenderer::PaintHelper
@@ -77,6 +89,25 @@ QSGTexture* QskGraphicTextureFactory::createTexture( QQuickWindow* window ) cons
     };
 
     PaintHelper helper( m_graphic, m_colorFilter );
+
+    if ( m_mipmapped )
+    {
+        QImage image( m_size, QImage::Format_RGBA8888_Premultiplied );
+        image.fill( Qt::transparent );
+
+        {
+            QPainter painter( &image );
+            helper.paint( &painter, m_size );
+        }
+
+        auto texture = window->createTextureFromImage( image,
+            QQuickWindow::TextureHasAlphaChannel | QQuickWindow::TextureHasMipmaps );
+
+        texture->setMipmapFiltering( QSGTexture::Linear );
+
+        return texture;
+    }
+
     return QskTextureRenderer::createPaintedTexture( window, m_size, &helper );
 }
 
@@ -87,7 +118,10 @@ QSize QskGraphicTextureFactory::textureSize() const
 
 int QskGraphicTextureFactory::textureByteCount() const
 {
-    return m_size.width() * m_size.height() * 4;
+    const int count = m_size.width() * m_size.height() * 4;
+
+    // the mipmap levels need another third
+    return m_mipmapped ? count + count / 3 : count;
 }
 
 QImage QskGraphicTextureFactory::image() const
@@ -28,6 +28,14 @@ class QSK_EXPORT QskGraphicTextureFactory : public QQuickTextureFactory
     void setSize( const QSize& size );
     QSize size() const;
 
+    /*
+        Creating the texture from an image, so that the scene graph
+        can generate mipmaps. Otherwise the texture might be painted
+        by OpenGL into a FBO, that has no mipmaps.
+     */
+    void setMipmapped( bool );
+    bool isMipmapped() const;
+
     QSGTexture* createTexture( QQuickWindow* ) const override;
     QSize textureSize() const override;
     int textureByteCount() const override;
@@ -40,6 +48,7 @@ class QSK_EXPORT QskGraphicTextureFactory : public QQuickTextureFactory
     QskGraphic m_graphic;
     QskColorFilter m_colorFilter;
     QSize m_size;
+    bool m_mipmapped = false;
 };
 
 #endif
@@ -5,8 +5,82 @@
 
 #include "QskPainterCommand.h"
 
+#include <qatomic.h>
+
+template< typename T, typename Create >
+static inline T* qskDeferredValue( QAtomicPointer< T >& value, Create create )
+{
+    auto v = value.loadAcquire();
+    if ( v == nullptr )
+    {
+        /*
+            The payload might be requested from the scene graph thread
+            and the GUI thread at the same time. In the rare case of
+            a collision we simply drop one of the results.
+         */
+        auto newValue = create();
+
+        if ( value.testAndSetOrdered( nullptr, newValue ) )
+        {
+            v = newValue;
+        }
+        else
+        {
+            delete newValue;
+            v = value.loadAcquire();
+        }
+    }
+
+    return v;
+}
+
+class QskPainterCommand::DeferredData
+{
+  public:
+    ~DeferredData()
+    {
+        delete m_path.loadRelaxed();
+        delete m_pixmapData.loadRelaxed();
+        delete m_imageData.loadRelaxed();
+    }
+
+    const QPainterPath* path()
+    {
+        return qskDeferredValue( m_path,
+            [ this ] { return new QPainterPath( pathLoader() ); } );
+    }
+
+    const PixmapData* pixmapData()
+    {
+        return qskDeferredValue( m_pixmapData,
+            [ this ] { return new PixmapData{ rect, pixmapLoader(), subRect }; } );
+    }
+
+    const ImageData* imageData()
+    {
+        return qskDeferredValue( m_imageData,
+            [ this ] { return new ImageData{ rect, imageLoader(), subRect, flags }; } );
+    }
+
+    QAtomicInt ref { 1 };
+
+    QRectF rect;
+    QRectF subRect;
+    Qt::ImageConversionFlags flags;
+
+    std::function< QPainterPath() > pathLoader;
+    std::function< QPixmap() > pixmapLoader;
+    std::function< QImage() > imageLoader;
+
+  private:
+    QAtomicPointer< QPainterPath > m_path;
+    QAtomicPointer< PixmapData > m_pixmapData;
+    QAtomicPointer< ImageData > m_imageData;
+};
+
 QskPainterCommand::QskPainterCommand( const QPainterPath& path )
     : m_type( Path )
+    , m_isDeferred( false )
 {
     m_path = new QPainterPath( path );
 }
@@ -14,6 +88,7 @@ QskPainterCommand::QskPainterCommand( const QPainterPath& path )
 QskPainterCommand::QskPainterCommand( const QRectF& rect,
         const QPixmap& pixmap, const QRectF& subRect )
     : m_type( Pixmap )
+    , m_isDeferred( false )
 {
     m_pixmapData = new PixmapData();
     m_pixmapData->rect = rect;
@@ -24,6 +99,7 @@ QskPainterCommand::QskPainterCommand( const QRectF& rect,
 QskPainterCommand::QskPainterCommand( const QRectF& rect,
         const QImage& image, const QRectF& subRect, Qt::ImageConversionFlags flags )
     : m_type( Image )
+    , m_isDeferred( false )
 {
     m_imageData = new ImageData();
     m_imageData->rect = rect;
@@ -34,12 +110,14 @@ QskPainterCommand::QskPainterCommand( const QRectF& rect,
 
 QskPainterCommand::QskPainterCommand( const QskPainterCommand::StateData& data )
     : m_type( State )
+    , m_isDeferred( false )
 {
     m_stateData = new StateData( data );
 }
 
 QskPainterCommand::QskPainterCommand( const QPaintEngineState& state )
     : m_type( State )
+    , m_isDeferred( false )
 {
     m_stateData = new StateData();
 
@@ -91,6 +169,39 @@ QskPainterCommand::QskPainterCommand( const QPaintEngineState& state )
         m_stateData->opacity = state.opacity();
 }
 
+QskPainterCommand::QskPainterCommand(
+        const std::function< QPainterPath() >& loader )
+    : m_type( Path )
+    , m_isDeferred( true )
+{
+    m_deferredData = new DeferredData();
+    m_deferredData->pathLoader = loader;
+}
+
+QskPainterCommand::QskPainterCommand( const QRectF& rect,
+        const std::function< QPixmap() >& loader, const QRectF& subRect )
+    : m_type( Pixmap )
+    , m_isDeferred( true )
+{
+    m_deferredData = new DeferredData();
+    m_deferredData->rect = rect;
+    m_deferredData->subRect = subRect;
+    m_deferredData->pixmapLoader = loader;
+}
+
+QskPainterCommand::QskPainterCommand( const QRectF& rect,
+        const std::function< QImage() >& loader, const QRectF& subRect,
+        Qt::ImageConversionFlags flags )
+    : m_type( Image )
+    , m_isDeferred( true )
+{
+    m_deferredData = new DeferredData();
+    m_deferredData->rect = rect;
+    m_deferredData->subRect = subRect;
+    m_deferredData->flags = flags;
+    m_deferredData->imageLoader = loader;
+}
+
 QskPainterCommand::QskPainterCommand( const QskPainterCommand& other )
 {
     copy( other );
@@ -114,6 +225,14 @@ bool QskPainterCommand::operator==( const QskPainterCommand& other ) const noexc
     if ( m_type != other.m_type )
         return false;
 
+    if ( m_isDeferred || other.m_isDeferred )
+    {
+        if ( m_isDeferred != other.m_isDeferred )
+            return false;
+
+        return m_deferredData == other.m_deferredData;
+    }
+
     switch ( m_type )
     {
         case Path:
@@ -229,6 +348,16 @@ bool QskPainterCommand::operator==( const QskPainterCommand& other ) const noexc
 void QskPainterCommand::copy( const QskPainterCommand& other )
 {
     m_type = other.m_type;
+    m_isDeferred = other.m_isDeferred;
+
+    if ( m_isDeferred )
+    {
+        // the payload is read only and can be shared
+        m_deferredData = other.m_deferredData;
+        m_deferredData->ref.ref();
+
+        return;
+    }
 
     switch ( other.m_type )
     {
@@ -259,6 +388,17 @@ void QskPainterCommand::copy( const QskPainterCommand& other )
 
 void QskPainterCommand::reset()
 {
+    if ( m_isDeferred )
+    {
+        if ( !m_deferredData->ref.deref() )
+            delete m_deferredData;
+
+        m_type = Invalid;
+        m_isDeferred = false;
+
+        return;
+    }
+
     switch ( m_type )
     {
         case Path:
@@ -288,18 +428,87 @@ void QskPainterCommand::reset()
     m_type = Invalid;
 }
 
+void QskPainterCommand::detach()
+{
+    /*
+        The payload of a deferred command might be shared between
+        several commands. Before giving write access we turn it into
+        a regular command.
+     */
+    if ( !m_isDeferred )
+        return;
+
+    QskPainterCommand command;
+
+    switch ( m_type )
+    {
+        case Path:
+        {
+            command = QskPainterCommand( *m_deferredData->path() );
+            break;
+        }
+        case Pixmap:
+        {
+            const auto data = m_deferredData->pixmapData();
+            command = QskPainterCommand( data->rect, data->pixmap, data->subRect );
+            break;
+        }
+        case Image:
+        {
+            const auto data = m_deferredData->imageData();
+            command = QskPainterCommand( data->rect,
+                data->image, data->subRect, data->flags );
+            break;
+        }
+        default:
+            break;
+    }
+
+    *this = command;
+}
+
+//! \return Painter path to be painted
+const QPainterPath* QskPainterCommand::path() const noexcept
+{
+    if ( m_isDeferred )
+        return m_deferredData->path();
+
+    return m_path;
+}
+
 QPainterPath* QskPainterCommand::path() noexcept
 {
+    detach();
     return m_path;
 }
 
+//! \return Attributes how to paint a QPixmap
+const QskPainterCommand::PixmapData* QskPainterCommand::pixmapData() const noexcept
+{
+    if ( m_isDeferred )
+        return m_deferredData->pixmapData();
+
+    return m_pixmapData;
+}
+
 QskPainterCommand::PixmapData* QskPainterCommand::pixmapData() noexcept
 {
+    detach();
     return m_pixmapData;
 }
 
+//! \return Attributes how to paint a QImage
+const QskPainterCommand::ImageData* QskPainterCommand::imageData() const noexcept
+{
+    if ( m_isDeferred )
+        return m_deferredData->imageData();
+
+    return m_imageData;
+}
+
 QskPainterCommand::ImageData* QskPainterCommand::imageData() noexcept
 {
+    detach();
     return m_imageData;
 }
 
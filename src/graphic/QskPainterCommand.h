@@ -13,6 +13,8 @@
 #include <qpainterpath.h>
 #include <qpixmap.h>
 
+#include <functional>
+
 class QSK_EXPORT QskPainterCommand
 {
   public:
@@ -90,6 +92,19 @@ class QSK_EXPORT QskPainterCommand
     explicit QskPainterCommand( const QskPainterCommand::StateData& data );
     explicit QskPainterCommand( const QPaintEngineState& );
 
+    /*
+        Commands, where the path or the raster data is created from
+        the loader, when being accessed for the first time.
+     */
+    explicit QskPainterCommand( const std::function< QPainterPath() >& );
+
+    QskPainterCommand( const QRectF& rect,
+        const std::function< QPixmap() >&, const QRectF& subRect );
+
+    QskPainterCommand( const QRectF& rect,
+        const std::function< QImage() >&, const QRectF& subRect,
+        Qt::ImageConversionFlags );
+
     ~QskPainterCommand();
 
     QskPainterCommand& operator=( const QskPainterCommand& );
@@ -111,11 +126,17 @@ class QSK_EXPORT QskPainterCommand
     StateData* stateData() noexcept;
     const StateData* stateData() const noexcept;
 
+    bool isDeferred() const noexcept;
+
   private:
+    class DeferredData;
+
     void copy( const QskPainterCommand& );
     void reset();
+    void detach();
 
     Type m_type;
+    bool m_isDeferred;
 
     union
     {
@@ -123,11 +144,13 @@ class QSK_EXPORT QskPainterCommand
         PixmapData* m_pixmapData;
         ImageData* m_imageData;
         StateData* m_stateData;
+        DeferredData* m_deferredData;
     };
 };
 
 constexpr inline QskPainterCommand::QskPainterCommand() noexcept
     : m_type( Invalid )
+    , m_isDeferred( false )
     , m_path( nullptr )
 {
 }
@@ -143,24 +166,10 @@ inline QskPainterCommand::Type QskPainterCommand::type() const noexcept
     return m_type;
 }
 
-//! \return Painter path to be painted
-inline const QPainterPath* QskPainterCommand::path() const noexcept
-{
-    return m_path;
-}
-
-//! \return Attributes how to paint a QPixmap
-inline const QskPainterCommand::PixmapData*
-QskPainterCommand::pixmapData() const noexcept
-{
-    return m_pixmapData;
-}
-
-//! \return Attributes how to paint a QImage
-inline const QskPainterCommand::ImageData*
-QskPainterCommand::imageData() const noexcept
+//! \return True, when the payload is created on demand
+inline bool QskPainterCommand::isDeferred() const noexcept
 {
-    return m_imageData;
+    return m_isDeferred;
 }
 
 //! \return Attributes of a state change
@@ -218,6 +218,127 @@ static QSet< int > qskKeyCodes( const QskVirtualKeyboardLayouts::Layout& layout
     return codes;
 }
 
+static const QskVirtualKeyboardLayouts::Layout* qskLayout( const QLocale& locale )
+{
+    const QskVirtualKeyboardLayouts::Layout* newLayout = nullptr;
+
+    switch ( locale.language() )
+    {
+        case QLocale::Bulgarian:
+            newLayout = &qskKeyboardLayouts.bg;
+            break;
+
+        case QLocale::Czech:
+            newLayout = &qskKeyboardLayouts.cs;
+            break;
+
+        case QLocale::German:
+            newLayout = &qskKeyboardLayouts.de;
+            break;
+
+        case QLocale::Danish:
+            newLayout = &qskKeyboardLayouts.da;
+            break;
+
+        case QLocale::Greek:
+            newLayout = &qskKeyboardLayouts.el;
+            break;
+
+        case QLocale::English:
+        {
+            switch ( locale.country() )
+            {
+                case QLocale::Canada:
+                case QLocale::UnitedStates:
+                case QLocale::UnitedStatesMinorOutlyingIslands:
+                case QLocale::UnitedStatesVirginIslands:
+                    newLayout = &qskKeyboardLayouts.en_US;
+                    break;
+
+                default:
+                    newLayout = &qskKeyboardLayouts.en_GB;
+                    break;
+            }
+
+            break;
+        }
+
+        case QLocale::Spanish:
+            newLayout = &qskKeyboardLayouts.es;
+            break;
+
+        case QLocale::Finnish:
+            newLayout = &qskKeyboardLayouts.fi;
+            break;
+
+        case QLocale::French:
+            newLayout = &qskKeyboardLayouts.fr;
+            break;
+
+        case QLocale::Hungarian:
+            newLayout = &qskKeyboardLayouts.hu;
+            break;
+
+        case QLocale::Italian:
+            newLayout = &qskKeyboardLayouts.it;
+            break;
+
+        case QLocale::Japanese:
+            newLayout = &qskKeyboardLayouts.ja;
+            break;
+
+        case QLocale::Latvian:
+            newLayout = &qskKeyboardLayouts.lv;
+            break;
+
+        case QLocale::Lithuanian:
+            newLayout = &qskKeyboardLayouts.lt;
+            break;
+
+        case QLocale::Dutch:
+            newLayout = &qskKeyboardLayouts.nl;
+            break;
+
+        case QLocale::Portuguese:
+            newLayout = &qskKeyboardLayouts.pt;
+            break;
+
+        case QLocale::Romanian:
+            newLayout = &qskKeyboardLayouts.ro;
+            break;
+
+        case QLocale::Russian:
+            newLayout = &qskKeyboardLayouts.ru;
+            break;
+
+        case QLocale::Slovenian:
+            newLayout = &qskKeyboardLayouts.sl;
+            break;
+
+        case QLocale::Slovak:
+            newLayout = &qskKeyboardLayouts.sk;
+            break;
+
+        case QLocale::Turkish:
+            newLayout = &qskKeyboardLayouts.tr;
+            break;
+
+        case QLocale::Chinese:
+            newLayout = &qskKeyboardLayouts.zh;
+            break;
+#if 1
+        case QLocale::C:
+            newLayout = &qskKeyboardLayouts.en_US;
+            break;
+#endif
+        default:
+            qWarning() << "QskVirtualKeyboard: unsupported locale:" << locale;
+            newLayout = &qskKeyboardLayouts.en_US;
+    }
+
+    return newLayout;
+}
+
 QSK_SUBCONTROL( QskVirtualKeyboard, Panel )
 QSK_SUBCONTROL( QskVirtualKeyboard, ButtonPanel )
 QSK_SUBCONTROL( QskVirtualKeyboard, ButtonText )
@@ -436,130 +557,41 @@ void QskVirtualKeyboard::buttonPressed()
 
 void QskVirtualKeyboard::updateLocale( const QLocale& locale )
 {
-    const QskVirtualKeyboardLayouts::Layout* newLayout = nullptr;
+    const auto newLayout = qskLayout( locale );
 
-    switch ( locale.language() )
+    if ( newLayout != m_data->currentLayout )
     {
-        case QLocale::Bulgarian:
-            newLayout = &qskKeyboardLayouts.bg;
-            break;
+        m_data->currentLayout = newLayout;
+        m_data->keyCodes = qskKeyCodes( *newLayout );
 
-        case QLocale::Czech:
-            newLayout = &qskKeyboardLayouts.cs;
-            break;
+        setMode( LowercaseMode );
+        polish();
+    }
+}
 
-        case QLocale::German:
-            newLayout = &qskKeyboardLayouts.de;
-            break;
+QString QskVirtualKeyboard::keyCharacters( const QLocale& locale )
+{
+    const auto& layout = *qskLayout( locale );
 
-        case QLocale::Danish:
-            newLayout = &qskKeyboardLayouts.da;
-            break;
+    QString characters;
 
-        case QLocale::Greek:
-            newLayout = &qskKeyboardLayouts.el;
-            break;
+    for ( int mode = 0; mode < QskVirtualKeyboard::ModeCount; mode++ )
+    {
+        const auto& keyCodes = layout[ mode ];
 
-        case QLocale::English:
+        for ( int row = 0; row < RowCount; row++ )
         {
-            switch ( locale.country() )
-            {
-                case QLocale::Canada:
-                case QLocale::UnitedStates:
-                case QLocale::UnitedStatesMinorOutlyingIslands:
-                case QLocale::UnitedStatesVirginIslands:
-                    newLayout = &qskKeyboardLayouts.en_US;
-                    break;
+            const auto& keys = keyCodes.data[ row ];
 
-                default:
-                    newLayout = &qskKeyboardLayouts.en_GB;
-                    break;
+            for ( int col = 0; col < ColumnCount; col++ )
+            {
+                if ( keys[ col ] )
+                    characters += qskTextForKey( keys[ col ] );
             }
-
-            break;
         }
-
-        case QLocale::Spanish:
-            newLayout = &qskKeyboardLayouts.es;
-            break;
-
-        case QLocale::Finnish:
-            newLayout = &qskKeyboardLayouts.fi;
-            break;
-
-        case QLocale::French:
-            newLayout = &qskKeyboardLayouts.fr;
-            break;
-
-        case QLocale::Hungarian:
-            newLayout = &qskKeyboardLayouts.hu;
-            break;
-
-        case QLocale::Italian:
-            newLayout = &qskKeyboardLayouts.it;
-            break;
-
-        case QLocale::Japanese:
-            newLayout = &qskKeyboardLayouts.ja;
-            break;
-
-        case QLocale::Latvian:
-            newLayout = &qskKeyboardLayouts.lv;
-            break;
-
-        case QLocale::Lithuanian:
-            newLayout = &qskKeyboardLayouts.lt;
-            break;
-
-        case QLocale::Dutch:
-            newLayout = &qskKeyboardLayouts.nl;
-            break;
-
-        case QLocale::Portuguese:
-            newLayout = &qskKeyboardLayouts.pt;
-            break;
-
-        case QLocale::Romanian:
-            newLayout = &qskKeyboardLayouts.ro;
-            break;
-
-        case QLocale::Russian:
-            newLayout = &qskKeyboardLayouts.ru;
-            break;
-
-        case QLocale::Slovenian:
-            newLayout = &qskKeyboardLayouts.sl;
-            break;
-
-        case QLocale::Slovak:
-            newLayout = &qskKeyboardLayouts.sk;
-            break;
-
-        case QLocale::Turkish:
-            newLayout = &qskKeyboardLayouts.tr;
-            break;
-
-        case QLocale::Chinese:
-            newLayout = &qskKeyboardLayouts.zh;
-            break;
-#if 1
-        case QLocale::C:
-            newLayout = &qskKeyboardLayouts.en_US;
-            break;
-#endif
-        default:
-            qWarning() << "QskVirtualKeyboard: unsupported locale:" << locale;
-            newLayout = &qskKeyboardLayouts.en_US;
     }
 
-    if ( newLayout != m_data->currentLayout )
-    {
-        m_data->currentLayout = newLayout;
-        m_data->keyCodes = qskKeyCodes( *newLayout );
-
-        setMode( LowercaseMode );
-        polish();
-    }
+    return characters;
 }
 
 void QskVirtualKeyboard::setMode( QskVirtualKeyboard::Mode mode )
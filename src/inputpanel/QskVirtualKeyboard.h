@@ -37,6 +37,9 @@ class QSK_EXPORT QskVirtualKeyboard : public QskBox
 
     bool hasKey( int keyCode ) const;
 
+    // the texts of all keys of the layout for a locale
+    static QString keyCharacters( const QLocale& );
+
   Q_SIGNALS:
     void modeChanged( Mode );
     void keySelected( int keyCode );
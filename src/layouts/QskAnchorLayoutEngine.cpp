@@ -0,0 +1,499 @@
+/******************************************************************************
+ * QSkinny - Copyright (C) 2016 Uwe Rathmann
+ * This file may be used under the terms of the QSkinny License, Version 1.0
+ *****************************************************************************/
+
+#include "QskAnchorLayoutEngine.h"
+#include "QskLayoutMetrics.h"
+#include "QskQuick.h"
+
+#include "kiwi/Solver.h"
+#include "kiwi/Constraint.h"
+#include "kiwi/Variable.h"
+#include "kiwi/Expression.h"
+
+#include <qvector.h>
+
+#include <limits>
+#include <vector>
+
+using namespace QskKiwi;
+
+static inline Qt::Orientation qskOrientation( int edge )
+{
+    return ( edge <= Qt::AnchorRight ) ? Qt::Horizontal : Qt::Vertical;
+}
+
+namespace
+{
+    class Geometry
+    {
+      public:
+        Expression expressionAt( int anchorPoint ) const
+        {
+            switch( anchorPoint )
+            {
+                case Qt::AnchorLeft:
+                    return Term( m_left );
+
+                case Qt::AnchorHorizontalCenter:
+                    return m_left + 0.5 * m_width;
+
+                case Qt::AnchorRight:
+                    return m_left + m_width;
+
+                case Qt::AnchorTop:
+                    return Term( m_top );
+
+                case Qt::AnchorVerticalCenter:
+                    return m_top + 0.5 * m_height;
+
+                case Qt::AnchorBottom:
+                    return m_top + m_height;
+            }
+
+            return Expression();
+        }
+
+        inline const Variable& length( Qt::Orientation orientation ) const
+        {
+            return ( orientation == Qt::Horizontal ) ? m_width : m_height;
+        }
+
+        inline QRectF rect() const
+        {
+            return QRectF( m_left.value(), m_top.value(),
+                m_width.value(), m_height.value() );
+        }
+
+      private:
+        Variable m_left, m_top, m_width, m_height;
+    };
+
+    class Anchor
+    {
+      public:
+        int index1 = -1;
+        Qt::AnchorPoint edge1;
+
+        int index2 = -1; // -1: the layout rectangle
+        Qt::AnchorPoint edge2;
+    };
+
+    class AnchorSolver : public Solver
+    {
+      public:
+        AnchorSolver( bool isStretching )
+            : m_isStretching( isStretching )
+        {
+        }
+
+        void setup( const QVector< QQuickItem* >&, const QVector< Anchor >& );
+        void updateSizeConstraints( int index, const QQuickItem* );
+
+        void setEditing( bool );
+
+        QSizeF resolved();
+        QSizeF resolved( qreal width, qreal height );
+
+        inline QRectF geometryAt( int index ) const
+        {
+            return m_geometries[ index ].rect();
+        }
+
+      private:
+        Expression expressionAt( int index, int anchorPoint ) const;
+
+        void addSizeConstraints( int index, const QSizeF&,
+            RelationalOperator, double strength );
+
+        const bool m_isStretching;
+        bool m_isEditing = false;
+
+        Variable m_width, m_height;
+        QSizeF m_suggestedSize;
+
+        QVector< Geometry > m_geometries;
+
+        // constraints from the size hints, that need to be replaced on changes
+        QVector< std::vector< Constraint > > m_sizeConstraints;
+    };
+}
+
+void AnchorSolver::setup( const QVector< QQuickItem* >& items,
+    const QVector< Anchor >& anchors )
+{
+    m_geometries.resize( items.count() );
+    m_sizeConstraints.resize( items.count() );
+
+    for ( const auto& anchor : anchors )
+    {
+        const auto expr1 = expressionAt( anchor.index1, anchor.edge1 );
+        const auto expr2 = expressionAt( anchor.index2, anchor.edge2 );
+
+        addConstraint( expr1 == expr2 );
+
+        if ( m_isStretching && anchor.index2 >= 0 )
+        {
+            const auto o = qskOrientation( anchor.edge1 );
+
+            /*
+                A constraint with medium strength to make anchored item
+                being stretched according to their stretch factors s1, s2.
+                ( For the moment we don't support having specific factors. )
+             */
+            const auto s1 = 1.0;
+            const auto s2 = 1.0;
+
+            const auto& length1 = m_geometries[ anchor.index1 ].length( o );
+            const auto& length2 = m_geometries[ anchor.index2 ].length( o );
+
+            addConstraint( Constraint( length1 * s1 == length2 * s2, Strength::medium ) );
+        }
+    }
+
+    for ( int i = 0; i < items.count(); i++ )
+        updateSizeConstraints( i, items[ i ] );
+}
+
+void AnchorSolver::updateSizeConstraints( int index, const QQuickItem* item )
+{
+    auto& constraints = m_sizeConstraints[ index ];
+
+    for ( const auto& constraint : constraints )
+        removeConstraint( constraint );
+
+    constraints.clear();
+
+    const auto minSize = qskSizeConstraint( item, Qt::MinimumSize );
+    addSizeConstraints( index, minSize, OP_GE, Strength::required );
+
+    const auto maxSize = qskSizeConstraint( item, Qt::MaximumSize );
+    addSizeConstraints( index, maxSize, OP_LE, Strength::required );
+
+    const auto prefSize = qskSizeConstraint( item, Qt::PreferredSize );
+    addSizeConstraints( index, prefSize, OP_EQ, Strength::strong );
+}
+
+void AnchorSolver::addSizeConstraints( int index, const QSizeF& size,
+    RelationalOperator op, double strength )
+{
+    const auto& geometry = m_geometries[ index ];
+    auto& constraints = m_sizeConstraints[ index ];
+
+    // the solver seems to run into overflows with unlimited sizes
+
+    if ( size.width() >= 0.0 && size.width() < QskLayoutMetrics::unlimited )
+    {
+        const Constraint c( geometry.length( Qt::Horizontal ) - size.width(), op, strength );
+
+        addConstraint( c );
+        constraints.push_back( c );
+    }
+
+    if ( size.height() >= 0.0 && size.height() < QskLayoutMetrics::unlimited )
+    {
+        const Constraint c( geometry.length( Qt::Vertical ) - size.height(), op, strength );
+
+        addConstraint( c );
+        constraints.push_back( c );
+    }
+}
+
+Expression AnchorSolver::expressionAt( int index, int anchorPoint ) const
+{
+    if ( index >= 0 )
+        return m_geometries[ index ].expressionAt( anchorPoint );
+
+    switch( anchorPoint )
+    {
+        case Qt::AnchorLeft:
+        case Qt::AnchorTop:
+            return Expression( 0.0 );
+
+        case Qt::AnchorHorizontalCenter:
+            return Term( 0.5 * m_width );
+
+        case Qt::AnchorRight:
+            return Term( m_width );
+
+        case Qt::AnchorVerticalCenter:
+            return Term( 0.5 * m_height );
+
+        case Qt::AnchorBottom:
+            return Term( m_height );
+    }
+
+    return Expression();
+}
+
+void AnchorSolver::setEditing( bool on )
+{
+    if ( on == m_isEditing )
+        return;
+
+    if ( on )
+    {
+        const double strength = 0.9 * Strength::required;
+
+        addEditVariable( m_width, strength );
+        addEditVariable( m_height, strength );
+    }
+    else
+    {
+        removeEditVariable( m_width );
+        removeEditVariable( m_height );
+    }
+
+    m_isEditing = on;
+    m_suggestedSize = QSizeF();
+}
+
+QSizeF AnchorSolver::resolved()
+{
+    updateVariables();
+    return QSizeF( m_width.value(), m_height.value() );
+}
+
+QSizeF AnchorSolver::resolved( qreal width, qreal height )
+{
+    Q_ASSERT( m_isEditing );
+
+    /*
+        Suggesting a new value for an edit variable is solved
+        incrementally from the previous solution.
+     */
+    if ( width != m_suggestedSize.width() )
+        suggestValue( m_width, width );
+
+    if ( height != m_suggestedSize.height() )
+        suggestValue( m_height, height );
+
+    m_suggestedSize = QSizeF( width, height );
+
+    return resolved();
+}
+
+class QskAnchorLayoutEngine::PrivateData
+{
+  public:
+    AnchorSolver* layoutSolver()
+    {
+        if ( layoutSolverPtr == nullptr )
+        {
+            layoutSolverPtr.reset( new AnchorSolver( true ) );
+            layoutSolverPtr->setup( items, anchors );
+            layoutSolverPtr->setEditing( true );
+        }
+
+        return layoutSolverPtr.get();
+    }
+
+    AnchorSolver* hintSolver()
+    {
+        if ( hintSolverPtr == nullptr )
+        {
+            hintSolverPtr.reset( new AnchorSolver( false ) );
+            hintSolverPtr->setup( items, anchors );
+        }
+
+        return hintSolverPtr.get();
+    }
+
+    void updateHints()
+    {
+        /*
+             The solver seems to run into overflows with
+             std::numeric_limits< unsigned float >::max()
+         */
+        const qreal max = std::numeric_limits< unsigned int >::max();
+
+        auto solver = hintSolver();
+
+        solver->setEditing( false );
+        hints[ Qt::PreferredSize ] = solver->resolved();
+
+        solver->setEditing( true );
+        hints[ Qt::MinimumSize ] = solver->resolved( 0.0, 0.0 );
+        hints[ Qt::MaximumSize ] = solver->resolved( max, max );
+
+        hasValidHints = true;
+    }
+
+    int insertItem( QQuickItem* item )
+    {
+        int index = items.indexOf( item );
+        if ( index < 0 )
+        {
+            index = items.count();
+            items += item;
+        }
+
+        return index;
+    }
+
+    QVector< QQuickItem* > items;
+    QVector< Anchor > anchors;
+
+    std::unique_ptr< AnchorSolver > layoutSolverPtr;
+    std::unique_ptr< AnchorSolver > hintSolverPtr;
+
+    QSizeF hints[ 3 ];
+    bool hasValidHints = false;
+};
+
+QskAnchorLayoutEngine::QskAnchorLayoutEngine()
+    : m_data( new PrivateData() )
+{
+}
+
+QskAnchorLayoutEngine::~QskAnchorLayoutEngine()
+{
+}
+
+int QskAnchorLayoutEngine::count() const
+{
+    return m_data->items.count();
+}
+
+QQuickItem* QskAnchorLayoutEngine::itemAt( int index ) const
+{
+    return m_data->items.value( index, nullptr );
+}
+
+int QskAnchorLayoutEngine::indexOf( const QQuickItem* item ) const
+{
+    return m_data->items.indexOf( const_cast< QQuickItem* >( item ) );
+}
+
+void QskAnchorLayoutEngine::addAnchor( QQuickItem* item1,
+    Qt::AnchorPoint edge1, QQuickItem* item2, Qt::AnchorPoint edge2 )
+{
+    if ( item1 == nullptr || item1 == item2 )
+        return;
+
+    Anchor anchor;
+
+    anchor.index1 = m_data->insertItem( item1 );
+    anchor.edge1 = edge1;
+
+    anchor.index2 = item2 ? m_data->insertItem( item2 ) : -1;
+    anchor.edge2 = edge2;
+
+    m_data->anchors += anchor;
+
+    invalidate();
+}
+
+bool QskAnchorLayoutEngine::removeItem( const QQuickItem* item )
+{
+    const int index = indexOf( item );
+    if ( index < 0 )
+        return false;
+
+    auto& anchors = m_data->anchors;
+
+    for ( int i = anchors.count() - 1; i >= 0; i-- )
+    {
+        auto& anchor = anchors[ i ];
+
+        if ( anchor.index1 == index || anchor.index2 == index )
+        {
+            anchors.removeAt( i );
+            continue;
+        }
+
+        if ( anchor.index1 > index )
+            anchor.index1--;
+
+        if ( anchor.index2 > index )
+            anchor.index2--;
+    }
+
+    m_data->items.removeAt( index );
+    invalidate();
+
+    return true;
+}
+
+void QskAnchorLayoutEngine::clear()
+{
+    m_data->items.clear();
+    m_data->anchors.clear();
+
+    invalidate();
+}
+
+void QskAnchorLayoutEngine::invalidate()
+{
+    // the anchors have changed: the solvers have to be set up from scratch
+
+    m_data->layoutSolverPtr.reset();
+    m_data->hintSolverPtr.reset();
+
+    m_data->hasValidHints = false;
+}
+
+void QskAnchorLayoutEngine::invalidateElement( int index )
+{
+    if ( index < 0 || index >= m_data->items.count() )
+        return;
+
+    const auto item = m_data->items[ index ];
+
+    for ( auto solver : { m_data->layoutSolverPtr.get(), m_data->hintSolverPtr.get() } )
+    {
+        if ( solver )
+            solver->updateSizeConstraints( index, item );
+    }
+
+    m_data->hasValidHints = false;
+}
+
+QSizeF QskAnchorLayoutEngine::sizeHint(
+    Qt::SizeHint which, const QSizeF& constraint ) const
+{
+    if ( which < Qt::MinimumSize || which > Qt::MaximumSize )
+        return QSizeF();
+
+    if ( m_data->items.isEmpty() )
+        return QSizeF( 0.0, 0.0 );
+
+    if ( !m_data->hasValidHints )
+        m_data->updateHints();
+
+    /*
+        Anchors do not introduce any height-for-width dependencies:
+        the constraint has no effect on the other dimension.
+     */
+    const auto& size = m_data->hints[ which ];
+
+    QSizeF hint;
+
+    if ( constraint.width() < 0.0 )
+        hint.setWidth( size.width() );
+
+    if ( constraint.height() < 0.0 )
+        hint.setHeight( size.height() );
+
+    return hint;
+}
+
+void QskAnchorLayoutEngine::setGeometries( const QRectF& rect )
+{
+    if ( m_data->items.isEmpty() )
+        return;
+
+    auto solver = m_data->layoutSolver();
+    solver->resolved( rect.width(), rect.height() );
+
+    const auto& items = m_data->items;
+
+    for ( int i = 0; i < items.count(); i++ )
+    {
+        auto r = solver->geometryAt( i );
+        r.translate( rect.left(), rect.top() );
+
+        qskSetItemGeometry( items[ i ], r );
+    }
+}
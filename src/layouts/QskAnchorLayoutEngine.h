@@ -0,0 +1,62 @@
+/******************************************************************************
+ * QSkinny - Copyright (C) 2016 Uwe Rathmann
+ * This file may be used under the terms of the QSkinny License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QSK_ANCHOR_LAYOUT_ENGINE_H
+#define QSK_ANCHOR_LAYOUT_ENGINE_H
+
+#include "QskGlobal.h"
+
+#include <qnamespace.h>
+#include <memory>
+
+class QQuickItem;
+class QSizeF;
+class QRectF;
+
+/*
+    A layout engine, where the geometries of the items are found
+    by a constraint solver ( Cassowary ) from anchors between the edges
+    of the items and the layout rectangle.
+
+    The solvers are kept alive between layouts: resizing only suggests new
+    values for the edit variables of the width/height of the layout rectangle,
+    and changing the hints of an item only replaces its size constraints.
+ */
+
+class QSK_EXPORT QskAnchorLayoutEngine
+{
+  public:
+    QskAnchorLayoutEngine();
+    ~QskAnchorLayoutEngine();
+
+    int count() const;
+
+    QQuickItem* itemAt( int index ) const;
+    int indexOf( const QQuickItem* ) const;
+
+    // item2 == nullptr: anchoring to the layout rectangle
+    void addAnchor( QQuickItem* item1, Qt::AnchorPoint edge1,
+        QQuickItem* item2, Qt::AnchorPoint edge2 );
+
+    // removing the item and all of its anchors
+    bool removeItem( const QQuickItem* );
+    void clear();
+
+    void invalidate();
+
+    // the hints of one item have changed
+    void invalidateElement( int index );
+
+    QSizeF sizeHint( Qt::SizeHint, const QSizeF& constraint ) const;
+    void setGeometries( const QRectF& );
+
+  private:
+    Q_DISABLE_COPY( QskAnchorLayoutEngine )
+
+    class PrivateData;
+    std::unique_ptr< PrivateData > m_data;
+};
+
+#endif
@@ -20,9 +20,9 @@ static void qskSetItemActive( QObject* receiver, const QQuickItem* item, bool on
     if ( on )
     {
         auto sendLayoutRequest =
-            [receiver]()
+            [receiver, item]()
             {
-                QEvent event( QEvent::LayoutRequest );
+                QskLayoutRequestEvent event( item );
                 QCoreApplication::sendEvent( receiver, &event );
             };
 
@@ -85,6 +85,48 @@ static void qskUpdateFocusChain(
     }
 }
 
+static void qskRebuildFocusChain(
+    QskGridBox* box, const QskGridLayoutEngine* engine )
+{
+    // ordering all items by their cells in one pass
+
+    class Entry
+    {
+      public:
+        inline bool operator<( const Entry& other ) const
+        {
+            return cellIndex < other.cellIndex;
+        }
+
+        int cellIndex;
+        QQuickItem* item;
+    };
+
+    const int columnCount = engine->columnCount();
+
+    QVector< Entry > entries;
+    entries.reserve( engine->count() );
+
+    for ( int i = 0; i < engine->count(); i++ )
+    {
+        if ( const auto item = engine->itemAt( i ) )
+        {
+            const auto grid = engine->gridAt( i );
+            entries += Entry { grid.y() * columnCount + grid.x(), item };
+        }
+    }
+
+    std::stable_sort( entries.begin(), entries.end() );
+
+    QVector< QQuickItem* > items;
+    items.reserve( entries.count() );
+
+    for ( const auto& entry : qAsConst( entries ) )
+        items += entry.item;
+
+    qskRestackChildItems( box, items );
+}
+
 class QskGridBox::PrivateData
 {
   public:
@@ -180,6 +222,64 @@ int QskGridBox::addItem( QQuickItem* item,
     return index;
 }
 
+void QskGridBox::addItems( const QVector< QQuickItem* >& items,
+    int row, int column, int columnCount )
+{
+    if ( row < 0 || column < 0 )
+        return;
+
+    columnCount = qMax( columnCount, 1 );
+
+    auto& engine = m_data->engine;
+
+    int count = 0;
+
+    for ( auto item : items )
+    {
+        if ( item == nullptr || item == this )
+            continue;
+
+        if ( !qskPlacementPolicy( item ).isEffective() )
+        {
+            qWarning() << "Inserting an item that is to be ignored for layouting:"
+                << item->metaObject()->className();
+
+            qskSetPlacementPolicy( item, QskPlacementPolicy() );
+        }
+
+        const QRect itemGrid( column + count % columnCount,
+            row + count / columnCount, 1, 1 );
+
+        count++;
+
+        const int index = ( item->parentItem() == this ) ? indexOf( item ) : -1;
+
+        if ( index >= 0 )
+        {
+            engine.setGridAt( index, itemGrid );
+        }
+        else
+        {
+            if ( item->parent() == nullptr )
+                item->setParent( this );
+
+            if ( item->parentItem() != this )
+                item->setParentItem( this );
+
+            setItemActive( item, true );
+            engine.insertItem( item, itemGrid );
+        }
+    }
+
+    if ( count == 0 )
+        return;
+
+    qskRebuildFocusChain( this, &engine );
+
+    resetImplicitSize();
+    polish();
+}
+
 int QskGridBox::addSpacer( const QSizeF& spacing,
     int row, int column, int rowSpan, int columnSpan )
 {
@@ -463,7 +563,24 @@ bool QskGridBox::event( QEvent* event )
     {
         case QEvent::LayoutRequest:
         {
-            invalidate();
+            /*
+                When the request comes from one of our items we can
+                keep what we know about all the others.
+             */
+            const auto index = indexOf( qskLayoutRequestItem( event ) );
+
+            if ( index >= 0 )
+            {
+                m_data->engine.invalidateElement( index );
+
+                resetImplicitSize();
+                polish();
+            }
+            else
+            {
+                invalidate();
+            }
+
             break;
         }
         case QEvent::LayoutDirectionChange:
@@ -7,6 +7,7 @@
 #define QSK_GRID_BOX_H
 
 #include "QskBox.h"
+#include <qvector.h>
 
 class QSK_EXPORT QskGridBox : public QskBox
 {
@@ -34,6 +35,15 @@ class QSK_EXPORT QskGridBox : public QskBox
     int addItem( QQuickItem*, int row, int column,
         int rowSpan, int columnSpan, Qt::Alignment );
 
+    /*
+        Inserting many items at once: the cells are filled row by row
+        starting at ( row, column ) with columnCount items per row.
+        The layout and the tab focus chain are updated only once.
+        Items, that have been inserted before, are moved.
+     */
+    void addItems( const QVector< QQuickItem* >&,
+        int row, int column, int columnCount );
+
     Q_INVOKABLE int addSpacer( const QSizeF&,
         int row, int column, int rowSpan = 1, int columnSpan = 1 );
 
@@ -190,6 +190,11 @@ namespace
         bool isIgnored() const;
         QskLayoutChain::CellData cell( Qt::Orientation ) const;
 
+        QskLayoutMetrics metrics( Qt::Orientation,
+            qreal constraint, quint32 generation ) const;
+
+        void invalidateMetrics();
+
         void transpose();
 
       private:
@@ -202,6 +207,11 @@ namespace
 
         QRect m_grid;
         bool m_isSpacer;
+
+        // the most recent hints of the item
+        mutable QskLayoutMetrics m_metrics[ 2 ];
+        mutable qreal m_constraints[ 2 ] = { -2.0, -2.0 };
+        mutable quint32 m_generation = 0;
     };
 
     class ElementsVector : public std::vector< Element >
@@ -234,6 +244,14 @@ Element::Element( const Element& other )
         m_spacing = other.m_spacing;
     else
         m_item = other.m_item;
+
+    for ( int i = 0; i < 2; i++ )
+    {
+        m_metrics[ i ] = other.m_metrics[ i ];
+        m_constraints[ i ] = other.m_constraints[ i ];
+    }
+
+    m_generation = other.m_generation;
 }
 
 Element& Element::operator=( const Element& other )
@@ -247,6 +265,14 @@ Element& Element::operator=( const Element& other )
 
     m_grid = other.m_grid;
 
+    for ( int i = 0; i < 2; i++ )
+    {
+        m_metrics[ i ] = other.m_metrics[ i ];
+        m_constraints[ i ] = other.m_constraints[ i ];
+    }
+
+    m_generation = other.m_generation;
+
     return *this;
 }
 
@@ -308,6 +334,38 @@ QskLayoutChain::CellData Element::cell( Qt::Orientation orientation ) const
     return cell;
 }
 
+QskLayoutMetrics Element::metrics( Qt::Orientation orientation,
+    qreal constraint, quint32 generation ) const
+{
+    if ( m_generation != generation )
+    {
+        // all cached metrics have been invalidated
+        m_constraints[ 0 ] = m_constraints[ 1 ] = -2.0;
+        m_generation = generation;
+    }
+
+    const int index = ( orientation == Qt::Horizontal ) ? 0 : 1;
+
+    if ( m_constraints[ index ] != constraint )
+    {
+        QskLayoutStatistics::increment( QskLayoutStatistics::MetricsCacheMisses );
+
+        m_metrics[ index ] = qskItemMetrics( item(), orientation, constraint );
+        m_constraints[ index ] = constraint;
+    }
+    else
+    {
+        QskLayoutStatistics::increment( QskLayoutStatistics::MetricsCacheHits );
+    }
+
+    return m_metrics[ index ];
+}
+
+inline void Element::invalidateMetrics()
+{
+    m_constraints[ 0 ] = m_constraints[ 1 ] = -2.0;
+}
+
 void Element::transpose()
 {
     m_grid.setRect( m_grid.top(), m_grid.left(),
@@ -384,6 +442,8 @@ class QskGridLayoutEngine::PrivateData
 
     int rowCount = 0;
     int columnCount = 0;
+
+    quint32 metricsGeneration = 1;
 };
 
 QskGridLayoutEngine::QskGridLayoutEngine()
@@ -622,6 +682,15 @@ QRect QskGridLayoutEngine::effectiveGridAt( int index ) const
 
 void QskGridLayoutEngine::invalidateElementCache()
 {
+    // invalidating the metrics of all elements in O(1)
+    if ( ++m_data->metricsGeneration == 0 )
+        m_data->metricsGeneration = 1;
+}
+
+void QskGridLayoutEngine::invalidateElementCacheAt( int index )
+{
+    if ( auto element = m_data->elementAt( index ) )
+        element->invalidateMetrics();
 }
 
 void QskGridLayoutEngine::layoutItems()
@@ -689,7 +758,10 @@ void QskGridLayoutEngine::setupChain( Qt::Orientation orientation,
             auto cell = element.cell( orientation );
 
             if ( element.item() )
-                cell.metrics = qskItemMetrics( element.item(), orientation, constraint );
+            {
+                cell.metrics = element.metrics(
+                    orientation, constraint, m_data->metricsGeneration );
+            }
 
             chain.expandCell( grid.top(), cell );
         }
@@ -715,7 +787,8 @@ void QskGridLayoutEngine::setupChain( Qt::Orientation orientation,
             constraint = qskSegmentLength( constraints, grid.left(), grid.right() );
 
         auto cell = element->cell( orientation );
-        cell.metrics = qskItemMetrics( element->item(), orientation, constraint );
+        cell.metrics = element->metrics(
+            orientation, constraint, m_data->metricsGeneration );
 
         chain.expandCells( grid.top(), grid.height(), cell );
     }
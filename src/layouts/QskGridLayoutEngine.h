@@ -60,6 +60,7 @@ class QskGridLayoutEngine : public QskLayoutEngine2D
     int effectiveCount( Qt::Orientation ) const override;
 
     void invalidateElementCache() override;
+    void invalidateElementCacheAt( int index ) override;
 
     void setupChain( Qt::Orientation,
         const QskLayoutChain::Segments&, QskLayoutChain& ) const override;
@@ -44,6 +44,17 @@ bool QskIndexedLayoutBox::autoAddChildren() const
     return m_data->autoAddChildren;
 }
 
+void QskIndexedLayoutBox::addItems( const QVector< QQuickItem* >& items )
+{
+    insertItems( -1, items );
+}
+
+void QskIndexedLayoutBox::insertItems( int index, const QVector< QQuickItem* >& items )
+{
+    if ( !items.isEmpty() )
+        insertItemsInternal( index, items );
+}
+
 void QskIndexedLayoutBox::itemChange(
     QQuickItem::ItemChange change, const QQuickItem::ItemChangeData& value )
 {
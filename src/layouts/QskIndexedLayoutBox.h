@@ -7,6 +7,7 @@
 #define QSK_INDEXED_LAYOUT_BOX_H
 
 #include "QskBox.h"
+#include <qvector.h>
 
 class QSK_EXPORT QskIndexedLayoutBox : public QskBox
 {
@@ -24,6 +25,14 @@ class QSK_EXPORT QskIndexedLayoutBox : public QskBox
     void setAutoAddChildren( bool on = true );
     bool autoAddChildren() const;
 
+    /*
+        Inserting many items at once, with only one update of the layout
+        and the tab focus chain. Items, that have been inserted before,
+        are ignored.
+     */
+    void addItems( const QVector< QQuickItem* >& );
+    void insertItems( int index, const QVector< QQuickItem* >& );
+
   Q_SIGNALS:
     void autoAddChildrenChanged();
 
@@ -37,6 +46,8 @@ class QSK_EXPORT QskIndexedLayoutBox : public QskBox
     virtual void autoAddItem( QQuickItem* ) = 0;
     virtual void autoRemoveItem( QQuickItem* ) = 0;
 
+    virtual void insertItemsInternal( int index, const QVector< QQuickItem* >& ) = 0;
+
     class PrivateData;
     std::unique_ptr< PrivateData > m_data;
 };
@@ -225,23 +225,39 @@ bool QskLayoutChain::setSpacing( qreal spacing )
 }
 
 QskLayoutChain::Segments QskLayoutChain::segments( qreal size ) const
+{
+    Segments segments;
+    this->segments( size, segments );
+
+    return segments;
+}
+
+void QskLayoutChain::segments( qreal size, Segments& segments ) const
 {
     if ( m_validCells == 0 )
-        return Segments();
+    {
+        // clear() keeps the capacity
+        segments.clear();
+        return;
+    }
 
-    Segments segments;
+    /*
+        As long as the buffer is not shared and has the capacity
+        resize() does not allocate. All segments will be overwritten.
+     */
+    segments.resize( m_cells.size() );
 
     if ( size <= m_boundingMetrics.minimum() )
     {
-        segments = distributed( Qt::MinimumSize, 0.0, 0.0 );
+        distributed( Qt::MinimumSize, 0.0, 0.0, segments );
     }
     else if ( size < m_boundingMetrics.preferred() )
     {
-        segments = minimumExpanded( size );
+        minimumExpanded( size, segments );
     }
     else if ( size <= m_boundingMetrics.maximum() )
     {
-        segments = preferredStretched( size );
+        preferredStretched( size, segments );
     }
     else
     {
@@ -267,19 +283,15 @@ QskLayoutChain::Segments QskLayoutChain::segments( qreal size ) const
                 extra = padding / m_validCells;
         }
 
-        segments = distributed( Qt::MaximumSize, offset, extra );
+        distributed( Qt::MaximumSize, offset, extra, segments );
     }
-
-    return segments;
 }
 
-QskLayoutChain::Segments QskLayoutChain::distributed(
-    int which, qreal offset, const qreal extra ) const
+void QskLayoutChain::distributed( int which,
+    qreal offset, const qreal extra, Segments& segments ) const
 {
     qreal fillSpacing = 0.0;
 
-    Segments segments( m_cells.size() );
-
     for ( int i = 0; i < segments.count(); i++ )
     {
         const auto& cell = m_cells[i];
@@ -324,14 +336,10 @@ QskLayoutChain::Segments QskLayoutChain::distributed(
             }
         }
     }
-
-    return segments;
 }
 
-QskLayoutChain::Segments QskLayoutChain::minimumExpanded( qreal size ) const
+void QskLayoutChain::minimumExpanded( qreal size, Segments& segments ) const
 {
-    Segments segments( m_cells.size() );
-
     qreal fillSpacing = 0.0;
     qreal offset = 0.0;
 
@@ -371,18 +379,15 @@ QskLayoutChain::Segments QskLayoutChain::minimumExpanded( qreal size ) const
             offset += segment.length;
         }
     }
-
-    return segments;
 }
 
-QskLayoutChain::Segments QskLayoutChain::preferredStretched( qreal size ) const
+void QskLayoutChain::preferredStretched( qreal size, Segments& segments ) const
 {
     const int count = m_cells.size();
 
     qreal sumFactors = 0.0;
 
     QVarLengthArray< qreal > factors( count );
-    Segments segments( count );
 
     for ( int i = 0; i < count; i++ )
     {
@@ -471,8 +476,6 @@ QskLayoutChain::Segments QskLayoutChain::preferredStretched( qreal size ) const
 
         offset += segment.length;
     }
-
-    return segments;
 }
 
 #ifndef QT_NO_DEBUG_STREAM
@@ -72,16 +72,22 @@ class QskLayoutChain
     void setFillMode( int mode ) { m_fillMode = mode; }
     int fillMode() const { return m_fillMode; }
 
+    /*
+        Writing the segments into a buffer owned by the caller. When reusing
+        the same buffer for each layout pass no memory needs to be allocated.
+     */
+    void segments( qreal size, Segments& ) const;
     Segments segments( qreal size ) const;
+
     QskLayoutMetrics boundingMetrics() const { return m_boundingMetrics; }
 
     inline qreal constraint() const { return m_constraint; }
     inline int count() const { return m_cells.size(); }
 
   private:
-    Segments distributed( int which, qreal offset, qreal extra ) const;
-    Segments minimumExpanded( qreal size ) const;
-    Segments preferredStretched( qreal size ) const;
+    void distributed( int which, qreal offset, qreal extra, Segments& ) const;
+    void minimumExpanded( qreal size, Segments& ) const;
+    void preferredStretched( qreal size, Segments& ) const;
 
     QskLayoutMetrics m_boundingMetrics;
     qreal m_constraint = -2.0;
@@ -10,6 +10,26 @@
 
 #include <qguiapplication.h>
 
+#include <atomic>
+
+static std::atomic< quint64 > qskLayoutCounters[ QskLayoutStatistics::CounterCount ];
+
+quint64 QskLayoutStatistics::value( Counter counter )
+{
+    return qskLayoutCounters[ counter ].load( std::memory_order_relaxed );
+}
+
+void QskLayoutStatistics::reset()
+{
+    for ( auto& counter : qskLayoutCounters )
+        counter.store( 0, std::memory_order_relaxed );
+}
+
+void QskLayoutStatistics::increment( Counter counter )
+{
+    qskLayoutCounters[ counter ].fetch_add( 1, std::memory_order_relaxed );
+}
+
 namespace
 {
     class LayoutData
@@ -32,6 +52,57 @@ namespace
         QskLayoutChain::Segments rows;
         QskLayoutChain::Segments columns;
     };
+
+    /*
+        Height-for-width layouts ( f.e. wrapping texts in a grid ) are
+        asked for several constraints in a row: parent layouts are probing
+        different widths during a layout pass, and resizing a window
+        alternates between a couple of them. So we keep the recently
+        used states of a chain instead of rebuilding it each time.
+     */
+    class ChainCache
+    {
+      public:
+        enum { MaxCount = 8 };
+
+        inline void clear()
+        {
+            m_chains.clear();
+        }
+
+        bool restore( qreal constraint, int count, QskLayoutChain& chain )
+        {
+            for ( int i = 0; i < m_chains.size(); i++ )
+            {
+                const auto& cachedChain = m_chains[ i ];
+
+                if ( ( cachedChain.constraint() == constraint )
+                    && ( cachedChain.count() == count ) )
+                {
+                    chain = cachedChain;
+
+                    if ( i > 0 )
+                        m_chains.move( i, 0 );
+
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void store( const QskLayoutChain& chain )
+        {
+            if ( m_chains.size() >= MaxCount )
+                m_chains.removeLast();
+
+            m_chains.prepend( chain );
+        }
+
+      private:
+        // most recently used first
+        QVector< QskLayoutChain > m_chains;
+    };
 }
 
 class QskLayoutEngine2D::PrivateData
@@ -51,6 +122,11 @@ class QskLayoutEngine2D::PrivateData
         return ( orientation == Qt::Horizontal ) ? columnChain : rowChain;
     }
 
+    inline ChainCache& chainCache( Qt::Orientation orientation )
+    {
+        return ( orientation == Qt::Horizontal ) ? columnCache : rowCache;
+    }
+
     inline Qt::Alignment effectiveAlignment( Qt::Alignment alignment ) const
     {
         const auto align = static_cast< Qt::Alignment >( defaultAlignment );
@@ -67,11 +143,17 @@ class QskLayoutEngine2D::PrivateData
     QskLayoutChain columnChain;
     QskLayoutChain rowChain;
 
+    ChainCache columnCache;
+    ChainCache rowCache;
+
     QSizeF layoutSize;
 
     QskLayoutChain::Segments rows;
     QskLayoutChain::Segments columns;
 
+    // buffer for the constraints of height-for-width requests
+    QskLayoutChain::Segments constraints;
+
     const LayoutData* layoutData = nullptr;
 
     unsigned int defaultAlignment : 8;
@@ -193,6 +275,15 @@ bool QskLayoutEngine2D::setExtraSpacingAt( Qt::Edges edges )
         m_data->rowChain.setFillMode( fillMode );
     }
 
+    /*
+        The constraints for a chain are the segments of the other one,
+        that depend on the fill mode. As the cached chains are
+        identified by the total of the segments only, we have to
+        drop them.
+     */
+    m_data->columnCache.clear();
+    m_data->rowCache.clear();
+
     m_data->layoutSize = QSize();
     m_data->rows.clear();
     m_data->columns.clear();
@@ -220,6 +311,8 @@ void QskLayoutEngine2D::setGeometries( const QRectF& rect )
         In case we have items that send LayoutRequest events on
         geometry changes - what doesn't make much sense - we
         better make a ( implicitely shared ) copy of the rows/columns.
+        As the copy is gone before the next update of the segments
+        the buffers are not detached and can be reused.
      */
     LayoutData data;
     data.rows = m_data->rows;
@@ -339,7 +432,9 @@ QSizeF QskLayoutEngine2D::sizeHint(
         {
             setupChain( Qt::Horizontal );
 
-            const auto constraints = columnChain.segments( constraint.width() );
+            auto& constraints = m_data->constraints;
+            columnChain.segments( constraint.width(), constraints );
+
             setupChain( Qt::Vertical, constraints );
 
             break;
@@ -348,7 +443,9 @@ QSizeF QskLayoutEngine2D::sizeHint(
         {
             setupChain( Qt::Vertical );
 
-            const auto constraints = rowChain.segments( constraint.height() );
+            auto& constraints = m_data->constraints;
+            rowChain.segments( constraint.height(), constraints );
+
             setupChain( Qt::Horizontal, constraints );
 
             break;
@@ -389,13 +486,27 @@ void QskLayoutEngine2D::setupChain( Qt::Orientation orientation,
 
     if ( ( chain.constraint() == constraint ) && ( chain.count() == count ) )
     {
-        return; // already up to date
+        // already up to date
+        QskLayoutStatistics::increment( QskLayoutStatistics::ChainCacheHits );
+        return;
     }
 
+    auto& cache = m_data->chainCache( orientation );
+
+    if ( cache.restore( constraint, count, chain ) )
+    {
+        QskLayoutStatistics::increment( QskLayoutStatistics::ChainCacheHits );
+        return;
+    }
+
+    QskLayoutStatistics::increment( QskLayoutStatistics::ChainCacheMisses );
+
     chain.reset( count, constraint );
     setupChain( orientation, constraints, chain );
     chain.finish();
 
+    cache.store( chain );
+
 #if 0
     qDebug() << "==" << this << orientation << chain.count();
 
@@ -419,30 +530,30 @@ void QskLayoutEngine2D::updateSegments( const QSizeF& size ) const
         case QskSizePolicy::WidthForHeight:
         {
             setupChain( Qt::Vertical );
-            rows = rowChain.segments( size.height() );
+            rowChain.segments( size.height(), rows );
 
             setupChain( Qt::Horizontal, rows );
-            columns = columnChain.segments( size.width() );
+            columnChain.segments( size.width(), columns );
 
             break;
         }
         case QskSizePolicy::HeightForWidth:
         {
             setupChain( Qt::Horizontal );
-            columns = columnChain.segments( size.width() );
+            columnChain.segments( size.width(), columns );
 
-            setupChain( Qt::Vertical, m_data->columns );
-            rows = rowChain.segments( size.height() );
+            setupChain( Qt::Vertical, columns );
+            rowChain.segments( size.height(), rows );
 
             break;
         }
         default:
         {
             setupChain( Qt::Horizontal );
-            columns = columnChain.segments( size.width() );
+            columnChain.segments( size.width(), columns );
 
             setupChain( Qt::Vertical );
-            rows = rowChain.segments( size.height() );
+            rowChain.segments( size.height(), rows );
         }
     }
 
@@ -465,12 +576,40 @@ void QskLayoutEngine2D::invalidate( int what )
         m_data->rowChain.invalidate();
         m_data->columnChain.invalidate();
 
+        m_data->rowCache.clear();
+        m_data->columnCache.clear();
+
         m_data->layoutSize = QSize();
         m_data->rows.clear();
         m_data->columns.clear();
     }
 }
 
+void QskLayoutEngine2D::invalidateElement( int index )
+{
+    if ( m_data->blockInvalidate )
+        return;
+
+    if ( index < 0 || index >= count() )
+        return;
+
+    /*
+        The structure of the layout is unchanged and the engines
+        can keep what they know about all other elements. But the
+        chains need to be set up again.
+     */
+
+    m_data->constraintType = -1;
+    invalidateElementCacheAt( index );
+
+    invalidate( LayoutCache );
+}
+
+void QskLayoutEngine2D::invalidateElementCacheAt( int )
+{
+    invalidateElementCache();
+}
+
 QskSizePolicy::ConstraintType QskLayoutEngine2D::constraintType() const
 {
     if ( m_data->constraintType < 0 )
@@ -500,3 +639,22 @@ QskSizePolicy::ConstraintType QskLayoutEngine2D::constraintType() const
 
     return static_cast< QskSizePolicy::ConstraintType >( m_data->constraintType );
 }
+
+#ifndef QT_NO_DEBUG_STREAM
+
+#include <qdebug.h>
+
+void QskLayoutStatistics::debugStatistics( QDebug debug )
+{
+    QDebugStateSaver saver( debug );
+    debug.nospace();
+
+    debug << "LayoutCaches(";
+    debug << "chains: " << value( ChainCacheHits )
+          << '/' << value( ChainCacheMisses )
+          << ", metrics: " << value( MetricsCacheHits )
+          << '/' << value( MetricsCacheMisses );
+    debug << ')';
+}
+
+#endif
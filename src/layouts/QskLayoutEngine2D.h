@@ -14,6 +14,37 @@
 #include <memory>
 
 class QskLayoutElement;
+class QDebug;
+
+/*
+    Hits/misses of the caches of the layout engines,
+    intended for benchmarking the layout code.
+ */
+namespace QskLayoutStatistics
+{
+    enum Counter
+    {
+        // chains, that did not need to be recalculated
+        ChainCacheHits,
+        ChainCacheMisses,
+
+        // hints of the elements, that did not need to be requested from the items
+        MetricsCacheHits,
+        MetricsCacheMisses,
+
+        CounterCount
+    };
+
+    QSK_EXPORT quint64 value( Counter );
+    QSK_EXPORT void reset();
+
+    // called from the engines
+    void increment( Counter );
+
+#ifndef QT_NO_DEBUG_STREAM
+    QSK_EXPORT void debugStatistics( QDebug );
+#endif
+}
 
 class QskLayoutEngine2D
 {
@@ -42,6 +73,9 @@ class QskLayoutEngine2D
 
     void invalidate();
 
+    // the hints of one element have changed
+    void invalidateElement( int index );
+
     qreal widthForHeight( qreal height ) const;
     qreal heightForWidth( qreal width ) const;
 
@@ -69,6 +103,7 @@ class QskLayoutEngine2D
     virtual int effectiveCount( Qt::Orientation ) const = 0;
 
     virtual void invalidateElementCache() = 0;
+    virtual void invalidateElementCacheAt( int index );
     QskSizePolicy::ConstraintType constraintType() const;
 
     virtual QskSizePolicy sizePolicyAt( int index ) const = 0;
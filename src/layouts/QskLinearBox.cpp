@@ -8,6 +8,8 @@
 #include "QskEvent.h"
 #include "QskQuick.h"
 
+#include <qset.h>
+
 static void qskSetItemActive( QObject* receiver, const QQuickItem* item, bool on )
 {
     /*
@@ -18,9 +20,9 @@ static void qskSetItemActive( QObject* receiver, const QQuickItem* item, bool on
     if ( on )
     {
         auto sendLayoutRequest =
-            [receiver]()
+            [receiver, item]()
             {
-                QEvent event( QEvent::LayoutRequest );
+                QskLayoutRequestEvent event( item );
                 QCoreApplication::sendEvent( receiver, &event );
             };
 
@@ -248,7 +250,24 @@ bool QskLinearBox::event( QEvent* event )
     {
         case QEvent::LayoutRequest:
         {
-            invalidate();
+            /*
+                When the request comes from one of our items we can
+                keep what we know about all the others.
+             */
+            const auto index = indexOf( qskLayoutRequestItem( event ) );
+
+            if ( index >= 0 )
+            {
+                m_data->engine.invalidateElement( index );
+
+                resetImplicitSize();
+                polish();
+            }
+            else
+            {
+                invalidate();
+            }
+
             break;
         }
         case QEvent::LayoutDirectionChange:
@@ -473,6 +492,68 @@ int QskLinearBox::insertItem( int index, QQuickItem* item )
     return index;
 }
 
+void QskLinearBox::insertItemsInternal(
+    int index, const QVector< QQuickItem* >& items )
+{
+    auto& engine = m_data->engine;
+
+    QVector< QQuickItem* > newItems;
+    newItems.reserve( items.count() );
+
+    // to ignore items, that are listed more than once
+    QSet< const QQuickItem* > itemSet;
+    itemSet.reserve( items.count() );
+
+    for ( auto item : items )
+    {
+        if ( item == nullptr || item == this )
+            continue;
+
+        if ( itemSet.contains( item ) )
+            continue;
+
+        if ( ( item->parentItem() == this ) && ( indexOf( item ) >= 0 ) )
+            continue;
+
+        if ( !qskPlacementPolicy( item ).isEffective() )
+        {
+            qWarning() << "Inserting an item that is to be ignored for layouting:"
+                << item->metaObject()->className();
+
+            qskSetPlacementPolicy( item, QskPlacementPolicy() );
+        }
+
+        reparentItem( item );
+        setItemActive( item, true );
+
+        newItems += item;
+        itemSet += item;
+    }
+
+    if ( newItems.isEmpty() )
+        return;
+
+    engine.insertItems( newItems, index );
+
+    {
+        // Re-ordering the child items in one pass to have a proper focus tab chain
+
+        QVector< QQuickItem* > layoutItems;
+        layoutItems.reserve( engine.count() );
+
+        for ( int i = 0; i < engine.count(); i++ )
+        {
+            if ( auto item = engine.itemAt( i ) )
+                layoutItems += item;
+        }
+
+        qskRestackChildItems( this, layoutItems );
+    }
+
+    resetImplicitSize();
+    polish();
+}
+
 int QskLinearBox::addSpacer( qreal spacing, int stretchFactor )
 {
     return insertSpacer( -1, spacing, stretchFactor );
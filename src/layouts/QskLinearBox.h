@@ -112,6 +112,8 @@ class QSK_EXPORT QskLinearBox : public QskIndexedLayoutBox
     void autoAddItem( QQuickItem* ) override final;
     void autoRemoveItem( QQuickItem* ) override final;
 
+    void insertItemsInternal( int index, const QVector< QQuickItem* >& ) override final;
+
     void setItemActive( QQuickItem*, bool );
     void removeItemInternal( int index, bool unparent );
 
@@ -41,6 +41,11 @@ namespace
         QskLayoutChain::CellData cell(
             Qt::Orientation, bool isLayoutOrientation ) const;
 
+        QskLayoutMetrics metrics( Qt::Orientation,
+            qreal constraint, quint32 generation ) const;
+
+        void invalidateMetrics();
+
       private:
 
         union
@@ -51,6 +56,15 @@ namespace
 
         int m_stretch = -1;
         bool m_isSpacer;
+
+        /*
+            Asking the item for its hints is the expensive part of
+            setting up the chains. So we keep the most recent results
+            until the item indicates, that its hints have changed.
+         */
+        mutable QskLayoutMetrics m_metrics[ 2 ];
+        mutable qreal m_constraints[ 2 ] = { -2.0, -2.0 };
+        mutable quint32 m_generation = 0;
     };
 
     class ElementsVector : public std::vector< Element >
@@ -81,6 +95,14 @@ Element::Element( const Element& other )
         m_spacing = other.m_spacing;
     else
         m_item = other.m_item;
+
+    for ( int i = 0; i < 2; i++ )
+    {
+        m_metrics[ i ] = other.m_metrics[ i ];
+        m_constraints[ i ] = other.m_constraints[ i ];
+    }
+
+    m_generation = other.m_generation;
 }
 
 Element& Element::operator=( const Element& other )
@@ -94,6 +116,14 @@ Element& Element::operator=( const Element& other )
 
     m_stretch = other.m_stretch;
 
+    for ( int i = 0; i < 2; i++ )
+    {
+        m_metrics[ i ] = other.m_metrics[ i ];
+        m_constraints[ i ] = other.m_constraints[ i ];
+    }
+
+    m_generation = other.m_generation;
+
     return *this;
 }
 
@@ -160,6 +190,38 @@ QskLayoutChain::CellData Element::cell(
     return cell;
 }
 
+QskLayoutMetrics Element::metrics( Qt::Orientation orientation,
+    qreal constraint, quint32 generation ) const
+{
+    if ( m_generation != generation )
+    {
+        // all cached metrics have been invalidated
+        m_constraints[ 0 ] = m_constraints[ 1 ] = -2.0;
+        m_generation = generation;
+    }
+
+    const int index = ( orientation == Qt::Horizontal ) ? 0 : 1;
+
+    if ( m_constraints[ index ] != constraint )
+    {
+        QskLayoutStatistics::increment( QskLayoutStatistics::MetricsCacheMisses );
+
+        m_metrics[ index ] = qskItemMetrics( item(), orientation, constraint );
+        m_constraints[ index ] = constraint;
+    }
+    else
+    {
+        QskLayoutStatistics::increment( QskLayoutStatistics::MetricsCacheHits );
+    }
+
+    return m_metrics[ index ];
+}
+
+inline void Element::invalidateMetrics()
+{
+    m_constraints[ 0 ] = m_constraints[ 1 ] = -2.0;
+}
+
 class QskLinearLayoutEngine::PrivateData
 {
   public:
@@ -182,6 +244,7 @@ class QskLinearLayoutEngine::PrivateData
     ElementsVector elements;
 
     uint dimension;
+    quint32 metricsGeneration = 1;
 
     mutable int sumIgnored : 30;
     unsigned int orientation : 2;
@@ -286,6 +349,20 @@ int QskLinearLayoutEngine::insertItem( QQuickItem* item, int index )
     return index;
 }
 
+int QskLinearLayoutEngine::insertItems(
+    const QVector< QQuickItem* >& items, int index )
+{
+    auto& elements = m_data->elements;
+
+    if ( index < 0 || index > count() )
+        index = elements.count();
+
+    elements.insert( elements.begin() + index, items.constBegin(), items.constEnd() );
+
+    invalidate();
+    return index;
+}
+
 int QskLinearLayoutEngine::insertSpacerAt( int index, qreal spacing )
 {
     spacing = qMax( spacing, static_cast< qreal >( 0.0 ) );
@@ -459,6 +536,18 @@ int QskLinearLayoutEngine::effectiveCount() const
 void QskLinearLayoutEngine::invalidateElementCache()
 {
     m_data->sumIgnored = -1;
+
+    // invalidating the metrics of all elements in O(1)
+    if ( ++m_data->metricsGeneration == 0 )
+        m_data->metricsGeneration = 1;
+}
+
+void QskLinearLayoutEngine::invalidateElementCacheAt( int index )
+{
+    m_data->sumIgnored = -1;
+
+    if ( auto element = m_data->elementAt( index ) )
+        element->invalidateMetrics();
 }
 
 void QskLinearLayoutEngine::setupChain( Qt::Orientation orientation,
@@ -482,7 +571,10 @@ void QskLinearLayoutEngine::setupChain( Qt::Orientation orientation,
         auto cell = element.cell( orientation, isLayoutOrientation );
 
         if ( element.item() )
-            cell.metrics = qskItemMetrics( element.item(), orientation, constraint );
+        {
+            cell.metrics = element.metrics(
+                orientation, constraint, m_data->metricsGeneration );
+        }
 
         chain.expandCell( index2, cell );
 
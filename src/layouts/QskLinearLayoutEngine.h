@@ -10,6 +10,7 @@
 #include "QskLayoutEngine2D.h"
 
 #include <qnamespace.h>
+#include <qvector.h>
 #include <memory>
 
 class QQuickItem;
@@ -33,6 +34,8 @@ class QskLinearLayoutEngine : public QskLayoutEngine2D
     int insertItem( QQuickItem*, int index );
     int addItem( QQuickItem* );
 
+    int insertItems( const QVector< QQuickItem* >&, int index );
+
     int insertSpacerAt( int index, qreal spacing );
     int addSpacer( qreal spacing );
 
@@ -57,6 +60,7 @@ class QskLinearLayoutEngine : public QskLayoutEngine2D
     int effectiveCount( Qt::Orientation ) const override;
 
     void invalidateElementCache() override;
+    void invalidateElementCacheAt( int index ) override;
 
     virtual void setupChain( Qt::Orientation,
         const QskLayoutChain::Segments&, QskLayoutChain& ) const override;
@@ -9,13 +9,130 @@
 #include "QskQuick.h"
 
 #include <QPointer>
+#include <qhash.h>
+#include <qset.h>
+
+#include <algorithm>
+
+static void qskSetItemActive( QObject* receiver, const QQuickItem* item, bool on )
+{
+    /*
+        For QQuickItems not being derived from QskControl we manually
+        send QEvent::LayoutRequest events.
+     */
+
+    if ( on )
+    {
+        auto sendLayoutRequest =
+            [receiver, item]()
+            {
+                QskLayoutRequestEvent event( item );
+                QCoreApplication::sendEvent( receiver, &event );
+            };
+
+        QObject::connect( item, &QQuickItem::implicitWidthChanged,
+            receiver, sendLayoutRequest );
+
+        QObject::connect( item, &QQuickItem::implicitHeightChanged,
+            receiver, sendLayoutRequest );
+    }
+    else
+    {
+        QObject::disconnect( item, &QQuickItem::implicitWidthChanged, receiver, nullptr );
+        QObject::disconnect( item, &QQuickItem::implicitHeightChanged, receiver, nullptr );
+    }
+}
+
+namespace
+{
+    /*
+        Minimum/Preferred hints for the unconstrained and
+        the last constrained request
+     */
+    class HintCache
+    {
+      public:
+        inline bool lookup( Qt::SizeHint which,
+            const QSizeF& constraint, QSizeF& hint ) const
+        {
+            const auto& entry = m_entries[ which ][ slot( constraint ) ];
+
+            if ( entry.isValid && entry.constraint == constraint )
+            {
+                hint = entry.hint;
+                return true;
+            }
+
+            return false;
+        }
+
+        inline void insert( Qt::SizeHint which,
+            const QSizeF& constraint, const QSizeF& hint )
+        {
+            auto& entry = m_entries[ which ][ slot( constraint ) ];
+
+            entry.constraint = constraint;
+            entry.hint = hint;
+            entry.isValid = true;
+        }
+
+        inline void invalidate()
+        {
+            for ( auto& entries : m_entries )
+            {
+                for ( auto& entry : entries )
+                    entry.isValid = false;
+            }
+        }
+
+      private:
+        static inline int slot( const QSizeF& constraint )
+        {
+            return ( constraint.width() >= 0.0 || constraint.height() >= 0.0 ) ? 1 : 0;
+        }
+
+        struct Entry
+        {
+            QSizeF constraint;
+            QSizeF hint;
+            bool isValid = false;
+        };
+
+        // Qt::MinimumSize, Qt::PreferredSize
+        Entry m_entries[ 2 ][ 2 ];
+    };
+}
 
 class QskStackBox::PrivateData
 {
   public:
+    QSizeF itemHint( const QQuickItem* item,
+        Qt::SizeHint which, const QSizeF& constraint )
+    {
+        auto& cache = itemHints[ item ];
+
+        QSizeF hint;
+        if ( !cache.lookup( which, constraint, hint ) )
+        {
+            hint = qskSizeConstraint( item, which, constraint );
+            cache.insert( which, constraint, hint );
+        }
+
+        return hint;
+    }
+
     QVector< QQuickItem* > items;
     QPointer< QskStackBoxAnimator > animator;
 
+    /*
+        The hints of the items are cached, so that a stack box with many
+        heavy pages does not have to ask all of them each time its
+        own hint is requested. Only the hints of items, that have posted
+        a QEvent::LayoutRequest, are recalculated.
+     */
+    QHash< const QQuickItem*, HintCache > itemHints;
+    HintCache hints;
+
     int currentIndex = -1;
     Qt::Alignment defaultAlignment = Qt::AlignLeft | Qt::AlignVCenter;
 };
@@ -211,6 +328,8 @@ void QskStackBox::insertItem( int index, QQuickItem* item )
 
     const bool doAppend = ( index < 0 ) || ( index >= itemCount() );
 
+    bool isNew = true;
+
     if ( item->parentItem() == this )
     {
         const int oldIndex = indexOf( item );
@@ -225,12 +344,16 @@ void QskStackBox::insertItem( int index, QQuickItem* item )
             }
 
             m_data->items.removeAt( oldIndex );
+            isNew = false;
         }
     }
 
     if ( doAppend )
         index = itemCount();
 
+    if ( isNew && qskControlCast( item ) == nullptr )
+        qskSetItemActive( this, item, true );
+
     m_data->items.insert( index, item );
 
     const int oldCurrentIndex = m_data->currentIndex;
@@ -251,6 +374,8 @@ void QskStackBox::insertItem( int index, QQuickItem* item )
     if ( oldCurrentIndex != m_data->currentIndex )
         Q_EMIT currentIndexChanged( m_data->currentIndex );
 
+    m_data->hints.invalidate();
+
     resetImplicitSize();
     polish();
 }
@@ -264,6 +389,74 @@ void QskStackBox::insertItem(
     insertItem( index, item );
 }
 
+void QskStackBox::insertItemsInternal(
+    int index, const QVector< QQuickItem* >& items )
+{
+    QVector< QQuickItem* > newItems;
+    newItems.reserve( items.count() );
+
+    // to ignore items, that are listed more than once
+    QSet< const QQuickItem* > itemSet;
+    itemSet.reserve( items.count() );
+
+    for ( auto item : items )
+    {
+        if ( item == nullptr || item == this || indexOf( item ) >= 0 )
+            continue;
+
+        if ( itemSet.contains( item ) )
+            continue;
+
+        reparentItem( item );
+
+        if ( !qskPlacementPolicy( item ).isEffective() )
+        {
+            qWarning() << "Inserting an item that is to be ignored for layouting"
+                << item->metaObject()->className();
+
+            qskSetPlacementPolicy( item, QskPlacementPolicy() );
+        }
+
+        item->setVisible( false );
+
+        if ( qskControlCast( item ) == nullptr )
+            qskSetItemActive( this, item, true );
+
+        newItems += item;
+        itemSet += item;
+    }
+
+    if ( newItems.isEmpty() )
+        return;
+
+    if ( ( index < 0 ) || ( index >= itemCount() ) )
+        index = itemCount();
+
+    auto& currentIndex = m_data->currentIndex;
+    const int oldCurrentIndex = currentIndex;
+
+    m_data->items.insert( index, newItems.count(), nullptr );
+    std::copy( newItems.constBegin(), newItems.constEnd(), m_data->items.begin() + index );
+
+    if ( currentIndex < 0 )
+    {
+        currentIndex = 0;
+        m_data->items[ 0 ]->setVisible( true );
+    }
+    else if ( index <= currentIndex )
+    {
+        currentIndex += newItems.count();
+    }
+
+    if ( oldCurrentIndex != currentIndex )
+        Q_EMIT currentIndexChanged( currentIndex );
+
+    m_data->hints.invalidate();
+
+    resetImplicitSize();
+    polish();
+}
+
 void QskStackBox::removeAt( int index )
 {
     removeItemInternal( index, true );
@@ -274,13 +467,17 @@ void QskStackBox::removeItemInternal( int index, bool unparent )
     if ( index < 0 || index >= m_data->items.count() )
         return;
 
-    if ( unparent )
+    if ( auto item = m_data->items[ index ] )
     {
-        if ( auto item = m_data->items[ index ] )
+        qskSetItemActive( this, item, false );
+        m_data->itemHints.remove( item );
+
+        if ( unparent )
             unparentItem( item );
     }
 
     m_data->items.removeAt( index );
+    m_data->hints.invalidate();
 
     auto& currentIndex = m_data->currentIndex;
 
@@ -320,6 +517,8 @@ void QskStackBox::clear( bool autoDelete )
 {
     for ( const auto item : qAsConst( m_data->items ) )
     {
+        qskSetItemActive( this, item, false );
+
         if( autoDelete && ( item->parent() == this ) )
             delete item;
         else
@@ -328,6 +527,9 @@ void QskStackBox::clear( bool autoDelete )
 
     m_data->items.clear();
 
+    m_data->itemHints.clear();
+    m_data->hints.invalidate();
+
     if ( m_data->currentIndex >= 0 )
     {
         m_data->currentIndex = -1;
@@ -377,6 +579,10 @@ QSizeF QskStackBox::layoutSizeHint(
     if ( which == Qt::MaximumSize )
         return QSizeF();
 
+    QSizeF hint;
+    if ( m_data->hints.lookup( which, constraint, hint ) )
+        return hint;
+
     qreal w = -1.0;
     qreal h = -1.0;
 
@@ -390,25 +596,27 @@ QSizeF QskStackBox::layoutSizeHint(
 
         if ( constraint.width() >= 0.0 && policy.isConstrained( Qt::Vertical ) )
         {
-            const auto hint = qskSizeConstraint( item, which, constraint );
+            const auto hint = m_data->itemHint( item, which, constraint );
             h = qMax( h, hint.height() );
         }
         else if ( constraint.height() >= 0.0 && policy.isConstrained( Qt::Horizontal ) )
         {
-            const auto hint = qskSizeConstraint( item, which, constraint );
+            const auto hint = m_data->itemHint( item, which, constraint );
             w = qMax( w, hint.width() );
         }
         else
         {
-            const auto hint = qskSizeConstraint( item, which, QSizeF() );
+            const auto hint = m_data->itemHint( item, which, QSizeF() );
 
             w = qMax( w, hint.width() );
             h = qMax( h, hint.height() );
         }
     }
 
-    // minimum layout hint needs to be cached TODO ...
-    return QSizeF( w, h );
+    hint = QSizeF( w, h );
+    m_data->hints.insert( which, constraint, hint );
+
+    return hint;
 }
 
 bool QskStackBox::event( QEvent* event )
@@ -417,6 +625,15 @@ bool QskStackBox::event( QEvent* event )
     {
         case QEvent::LayoutRequest:
         {
+            const auto item = qskLayoutRequestItem( event );
+
+            if ( item && indexOf( item ) >= 0 )
+                m_data->itemHints.remove( item );
+            else
+                m_data->itemHints.clear();
+
+            m_data->hints.invalidate();
+
             resetImplicitSize();
             polish();
             break;
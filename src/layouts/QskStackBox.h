@@ -87,6 +87,7 @@ class QSK_EXPORT QskStackBox : public QskIndexedLayoutBox
     void autoAddItem( QQuickItem* ) override final;
     void autoRemoveItem( QQuickItem* ) override final;
 
+    void insertItemsInternal( int index, const QVector< QQuickItem* >& ) override final;
     void removeItemInternal( int index, bool unparent );
 
     class PrivateData;
@@ -15,6 +15,46 @@
 #include <qfontmetrics.h>
 #include <qmath.h>
 
+void QskSubcontrolHintCache::invalidate()
+{
+    m_count = m_next = 0;
+}
+
+bool QskSubcontrolHintCache::lookup( QskAspect::Subcontrol subControl,
+    QskAspect::States states, const QSizeF& constraint, QSizeF& hint ) const
+{
+    for ( int i = 0; i < m_count; i++ )
+    {
+        const auto& entry = m_entries[ i ];
+
+        if ( entry.subControl == subControl && entry.states == states
+            && entry.constraint == constraint )
+        {
+            hint = entry.hint;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void QskSubcontrolHintCache::insert( QskAspect::Subcontrol subControl,
+    QskAspect::States states, const QSizeF& constraint, const QSizeF& hint )
+{
+    // when being full we replace the oldest entry
+    auto& entry = m_entries[ m_next ];
+
+    entry.subControl = subControl;
+    entry.states = states;
+    entry.constraint = constraint;
+    entry.hint = hint;
+
+    m_next = ( m_next + 1 ) % Capacity;
+
+    if ( m_count < Capacity )
+        m_count++;
+}
+
 QskSubcontrolLayoutEngine::LayoutElement::LayoutElement(
         const QskSkinnable* skinnable, const QskAspect::Subcontrol subControl )
     : m_skinnable( skinnable )
@@ -107,7 +147,7 @@ QSizeF QskSubcontrolLayoutEngine::LayoutElement::sizeHint(
                 innerConstraint.setHeight( h );
             }
 
-            hint = implicitSize( innerConstraint );
+            hint = cachedImplicitSize( innerConstraint );
 
             if ( hint.width() >= 0 )
                 hint.setWidth( hint.width() + padding.width() );
@@ -119,7 +159,7 @@ QSizeF QskSubcontrolLayoutEngine::LayoutElement::sizeHint(
         {
             if ( !hint.isValid() )
             {
-                const auto sz = implicitSize( constraint );
+                const auto sz = cachedImplicitSize( constraint );
 
                 if ( hint.width() < 0 )
                     hint.setWidth( sz.width() );
@@ -138,6 +178,24 @@ QSizeF QskSubcontrolLayoutEngine::LayoutElement::sizeHint(
     return hint;
 }
 
+QSizeF QskSubcontrolLayoutEngine::LayoutElement::cachedImplicitSize(
+    const QSizeF& constraint ) const
+{
+    if ( m_hintCache == nullptr )
+        return implicitSize( constraint );
+
+    const auto states = m_skinnable->skinStates();
+
+    QSizeF hint;
+    if ( !m_hintCache->lookup( m_subControl, states, constraint, hint ) )
+    {
+        hint = implicitSize( constraint );
+        m_hintCache->insert( m_subControl, states, constraint, hint );
+    }
+
+    return hint;
+}
+
 QSizeF QskSubcontrolLayoutEngine::TextElement::implicitSize( const QSizeF& constraint ) const
 {
     const auto font = skinnable()->effectiveFont( subControl() );
@@ -281,6 +339,8 @@ class QskSubcontrolLayoutEngine::PrivateData
 
     Qt::Orientation orientation;
     QVector< LayoutElement* > elements;
+
+    QskSubcontrolHintCache* hintCache = nullptr;
 };
 
 QskSubcontrolLayoutEngine::QskSubcontrolLayoutEngine( Qt::Orientation orientation )
@@ -322,6 +382,21 @@ qreal QskSubcontrolLayoutEngine::spacing() const
     return Inherited::spacing( m_data->orientation );
 }
 
+void QskSubcontrolLayoutEngine::setHintCache( QskSubcontrolHintCache* cache )
+{
+    m_data->hintCache = cache;
+
+    for ( auto element : qAsConst( m_data->elements ) )
+        element->setHintCache( cache );
+
+    invalidate();
+}
+
+QskSubcontrolHintCache* QskSubcontrolLayoutEngine::hintCache() const
+{
+    return m_data->hintCache;
+}
+
 void QskSubcontrolLayoutEngine::setGraphicTextElements( const QskSkinnable* skinnable,
     QskAspect::Subcontrol textSubcontrol, const QString& text,
     QskAspect::Subcontrol graphicSubControl, const QSizeF& graphicSize )
@@ -340,6 +415,8 @@ void QskSubcontrolLayoutEngine::setGraphicTextElements( const QskSkinnable* skin
         if ( graphicElement == nullptr )
         {
             graphicElement = new GraphicElement( skinnable, graphicSubControl );
+            graphicElement->setHintCache( m_data->hintCache );
+
             m_data->elements.prepend( graphicElement );
         }
 
@@ -353,6 +430,8 @@ void QskSubcontrolLayoutEngine::setGraphicTextElements( const QskSkinnable* skin
         if ( textElement == nullptr )
         {
             textElement = new TextElement( skinnable, textSubcontrol );
+            textElement->setHintCache( m_data->hintCache );
+
             m_data->elements.append( textElement );
         }
 
@@ -409,6 +488,7 @@ void QskSubcontrolLayoutEngine::setGraphicTextElements( const QskSkinnable* skin
 
 void QskSubcontrolLayoutEngine::addElement( LayoutElement* element )
 {
+    element->setHintCache( m_data->hintCache );
     m_data->elements += element;
 }
 
@@ -16,6 +16,46 @@
 
 class QskSkinnable;
 
+/*
+    Implicit sizes of the elements of a control, that can be shared between
+    the temporary engines being set up for each size hint/layout request.
+    Measuring texts is expensive and the results usually do not change,
+    when a control is laid out again with the same constraints.
+
+    The control owning the cache has to invalidate it, whenever the text,
+    font, graphic or any skin hint affecting the implicit sizes changes.
+    Changes of the skin states are detected by the cache itself.
+ */
+class QskSubcontrolHintCache
+{
+  public:
+    void invalidate();
+
+    bool lookup( QskAspect::Subcontrol, QskAspect::States,
+        const QSizeF& constraint, QSizeF& hint ) const;
+
+    void insert( QskAspect::Subcontrol, QskAspect::States,
+        const QSizeF& constraint, const QSizeF& hint );
+
+  private:
+    struct Entry
+    {
+        QskAspect::Subcontrol subControl;
+        QskAspect::States states;
+
+        QSizeF constraint;
+        QSizeF hint;
+    };
+
+    // a couple of constraints for each element are enough
+    static constexpr int Capacity = 8;
+
+    Entry m_entries[ Capacity ];
+
+    int m_count = 0;
+    int m_next = 0;
+};
+
 /*
     For the moment this layout is tailored for arranging one text and one graphic
     horizontally/vertically. Candidate for becoming something more general in the future..
@@ -58,8 +98,12 @@ class QskSubcontrolLayoutEngine : public QskLayoutEngine2D
 
         void setExplicitSizeHint( Qt::SizeHint, const QSizeF& );
 
+        inline void setHintCache( QskSubcontrolHintCache* cache ) { m_hintCache = cache; }
+
       private:
         QSizeF sizeHint( Qt::SizeHint, const QSizeF& ) const override;
+        QSizeF cachedImplicitSize( const QSizeF& ) const;
+
         virtual QSizeF implicitSize( const QSizeF& ) const = 0;
 
         int m_stretch = -1;
@@ -71,6 +115,8 @@ class QskSubcontrolLayoutEngine : public QskLayoutEngine2D
 
         const QskSkinnable* m_skinnable;
         const QskAspect::Subcontrol m_subControl;
+
+        QskSubcontrolHintCache* m_hintCache = nullptr;
     };
 
     class TextElement : public LayoutElement
@@ -117,6 +163,10 @@ class QskSubcontrolLayoutEngine : public QskLayoutEngine2D
     void setSpacing( qreal );
     qreal spacing() const;
 
+    // the cache is not owned by the engine
+    void setHintCache( QskSubcontrolHintCache* );
+    QskSubcontrolHintCache* hintCache() const;
+
     void addElement( LayoutElement* );
     LayoutElement* elementAt( int ) const;
     LayoutElement* element( QskAspect::Subcontrol ) const;
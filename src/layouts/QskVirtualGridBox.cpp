@@ -0,0 +1,491 @@
+/******************************************************************************
+ * QSkinny - Copyright (C) 2016 Uwe Rathmann
+ * This file may be used under the terms of the QSkinny License, Version 1.0
+ *****************************************************************************/
+
+#include "QskVirtualGridBox.h"
+#include "QskEvent.h"
+#include "QskQuick.h"
+#include "QskScrollBox.h"
+
+#include <qhash.h>
+#include <qpointer.h>
+#include <qquickwindow.h>
+#include <qvector.h>
+
+#include <algorithm>
+#include <cmath>
+
+static inline qreal qskDefaultSpacing()
+{
+    return 5.0; // should be from the skin
+}
+
+static QskScrollBox* qskScrollBox( const QQuickItem* item )
+{
+    for ( auto p = item->parentItem(); p != nullptr; p = p->parentItem() )
+    {
+        if ( auto scrollBox = qobject_cast< QskScrollBox* >( p ) )
+            return scrollBox;
+    }
+
+    return nullptr;
+}
+
+static inline int qskBoundedIndex( qreal pos, qreal step, int count )
+{
+    const int index = static_cast< int >( std::floor( pos / step ) );
+    return qBound( 0, index, count - 1 );
+}
+
+class QskVirtualGridBox::PrivateData
+{
+  public:
+    inline int rowCount() const
+    {
+        return ( dimension > 0 ) ? ( count + dimension - 1 ) / dimension : 0;
+    }
+
+    inline bool isValid() const
+    {
+        return factory && ( count > 0 ) && ( dimension > 0 )
+            && ( cellSize.width() > 0.0 ) && ( cellSize.height() > 0.0 );
+    }
+
+    QQuickItem* takeItem( QQuickItem* box )
+    {
+        if ( !pool.isEmpty() )
+            return pool.takeLast();
+
+        auto item = factory();
+        if ( item )
+        {
+            item->setParentItem( box );
+            if ( item->parent() == nullptr )
+                item->setParent( box );
+        }
+
+        return item;
+    }
+
+    void deleteItems()
+    {
+        qDeleteAll( items );
+        items.clear();
+
+        qDeleteAll( pool );
+        pool.clear();
+    }
+
+    ItemFactory factory;
+    ItemBinder binder;
+
+    int count = 0;
+    int dimension = 1;
+
+    QSizeF cellSize;
+    qreal spacing = qskDefaultSpacing();
+    qreal overscan = 0.0;
+
+    // the instantiated items: index -> item
+    QHash< int, QQuickItem* > items;
+
+    // hidden items, waiting for being reused
+    QVector< QQuickItem* > pool;
+
+    QPointer< QskScrollBox > scrollBox;
+};
+
+QskVirtualGridBox::QskVirtualGridBox( QQuickItem* parent )
+    : Inherited( false, parent )
+    , m_data( new PrivateData() )
+{
+    setPolishOnResize( true );
+}
+
+QskVirtualGridBox::~QskVirtualGridBox()
+{
+}
+
+void QskVirtualGridBox::setDelegate(
+    const ItemFactory& factory, const ItemBinder& binder )
+{
+    // items from the previous factory can't be reused
+    m_data->deleteItems();
+
+    m_data->factory = factory;
+    m_data->binder = binder;
+
+    polish();
+}
+
+void QskVirtualGridBox::setCount( int count )
+{
+    count = qMax( count, 0 );
+
+    if ( count != m_data->count )
+    {
+        m_data->count = count;
+
+        resetImplicitSize();
+        polish();
+
+        Q_EMIT countChanged( count );
+    }
+}
+
+int QskVirtualGridBox::count() const
+{
+    return m_data->count;
+}
+
+void QskVirtualGridBox::setDimension( int dimension )
+{
+    dimension = qMax( dimension, 1 );
+
+    if ( dimension != m_data->dimension )
+    {
+        m_data->dimension = dimension;
+
+        resetImplicitSize();
+        polish();
+
+        Q_EMIT dimensionChanged( dimension );
+    }
+}
+
+int QskVirtualGridBox::dimension() const
+{
+    return m_data->dimension;
+}
+
+void QskVirtualGridBox::setCellSize( const QSizeF& size )
+{
+    const QSizeF cellSize( qMax( size.width(), 0.0 ), qMax( size.height(), 0.0 ) );
+
+    if ( cellSize != m_data->cellSize )
+    {
+        m_data->cellSize = cellSize;
+
+        resetImplicitSize();
+        polish();
+
+        Q_EMIT cellSizeChanged( cellSize );
+    }
+}
+
+QSizeF QskVirtualGridBox::cellSize() const
+{
+    return m_data->cellSize;
+}
+
+void QskVirtualGridBox::setSpacing( qreal spacing )
+{
+    spacing = qMax( spacing, 0.0 );
+
+    if ( spacing != m_data->spacing )
+    {
+        m_data->spacing = spacing;
+
+        resetImplicitSize();
+        polish();
+
+        Q_EMIT spacingChanged( spacing );
+    }
+}
+
+void QskVirtualGridBox::resetSpacing()
+{
+    setSpacing( qskDefaultSpacing() );
+}
+
+qreal QskVirtualGridBox::spacing() const
+{
+    return m_data->spacing;
+}
+
+void QskVirtualGridBox::setOverscan( qreal overscan )
+{
+    overscan = qMax( overscan, 0.0 );
+
+    if ( overscan != m_data->overscan )
+    {
+        m_data->overscan = overscan;
+        polish();
+
+        Q_EMIT overscanChanged( overscan );
+    }
+}
+
+qreal QskVirtualGridBox::overscan() const
+{
+    return m_data->overscan;
+}
+
+QRectF QskVirtualGridBox::cellRect( int index ) const
+{
+    if ( index < 0 || index >= m_data->count )
+        return QRectF();
+
+    const auto& cellSize = m_data->cellSize;
+    const auto spacing = m_data->spacing;
+
+    const int row = index / m_data->dimension;
+    const int col = index % m_data->dimension;
+
+    const auto pos = layoutRect().topLeft() + QPointF(
+        col * ( cellSize.width() + spacing ), row * ( cellSize.height() + spacing ) );
+
+    return QRectF( pos, cellSize );
+}
+
+QRectF QskVirtualGridBox::viewport() const
+{
+    const QRectF boxRect( 0.0, 0.0, width(), height() );
+
+    QRectF rect = boxRect;
+
+    if ( const auto scrollBox = m_data->scrollBox.data() )
+    {
+        rect = mapRectFromItem( scrollBox, scrollBox->viewContentsRect() );
+    }
+    else if ( const auto w = window() )
+    {
+        rect = mapRectFromScene( QRectF( 0.0, 0.0, w->width(), w->height() ) );
+    }
+
+    return rect & boxRect;
+}
+
+QQuickItem* QskVirtualGridBox::itemAtIndex( int index ) const
+{
+    return m_data->items.value( index, nullptr );
+}
+
+int QskVirtualGridBox::indexOf( const QQuickItem* item ) const
+{
+    if ( item && item->parentItem() == this )
+    {
+        for ( auto it = m_data->items.constBegin();
+            it != m_data->items.constEnd(); ++it )
+        {
+            if ( it.value() == item )
+                return it.key();
+        }
+    }
+
+    return -1;
+}
+
+int QskVirtualGridBox::instantiatedCount() const
+{
+    return m_data->items.count() + m_data->pool.count();
+}
+
+void QskVirtualGridBox::reload()
+{
+    // all items will be bound again in the next layout cycle
+    recycleItems();
+    polish();
+}
+
+void QskVirtualGridBox::recycleItems()
+{
+    auto& items = m_data->items;
+
+    for ( auto item : qAsConst( items ) )
+    {
+        item->setVisible( false );
+        m_data->pool += item;
+    }
+
+    items.clear();
+}
+
+void QskVirtualGridBox::updateViewportConnections()
+{
+    auto scrollBox = qskScrollBox( this );
+    if ( scrollBox == m_data->scrollBox )
+        return;
+
+    if ( m_data->scrollBox )
+        m_data->scrollBox->disconnect( this );
+
+    m_data->scrollBox = scrollBox;
+
+    if ( scrollBox )
+    {
+        /*
+            Moving the scrolled item already results in
+            a geometryChangeEvent, but the box might be
+            somewhere below the scrolled item.
+         */
+        connect( scrollBox, &QskScrollBox::scrollPosChanged,
+            this, &QQuickItem::polish );
+
+        connect( scrollBox, &QQuickItem::widthChanged,
+            this, &QQuickItem::polish );
+
+        connect( scrollBox, &QQuickItem::heightChanged,
+            this, &QQuickItem::polish );
+    }
+}
+
+void QskVirtualGridBox::geometryChangeEvent( QskGeometryChangeEvent* event )
+{
+    Inherited::geometryChangeEvent( event );
+
+    if ( event->isMoved() )
+    {
+        // the visible part of the box might have changed
+        polish();
+    }
+}
+
+void QskVirtualGridBox::itemChange(
+    QQuickItem::ItemChange change, const QQuickItem::ItemChangeData& value )
+{
+    Inherited::itemChange( change, value );
+
+    if ( change == QQuickItem::ItemParentHasChanged
+        || change == QQuickItem::ItemSceneChange )
+    {
+        polish();
+    }
+}
+
+void QskVirtualGridBox::updateLayout()
+{
+    updateViewportConnections();
+
+    auto& d = *m_data;
+
+    QRectF visibleRect;
+
+    if ( d.isValid() )
+    {
+        const auto r = layoutRect();
+
+        visibleRect = viewport().adjusted(
+            -d.overscan, -d.overscan, d.overscan, d.overscan );
+
+        visibleRect = visibleRect.translated( -r.topLeft() )
+            & QRectF( 0.0, 0.0, r.width(), r.height() );
+    }
+
+    if ( visibleRect.isEmpty() )
+    {
+        // the pool is kept for the next time we become visible
+        recycleItems();
+        return;
+    }
+
+    const qreal dx = d.cellSize.width() + d.spacing;
+    const qreal dy = d.cellSize.height() + d.spacing;
+
+    const int colMin = qskBoundedIndex( visibleRect.left(), dx, d.dimension );
+    const int colMax = qskBoundedIndex( visibleRect.right(), dx, d.dimension );
+
+    const int rowMin = qskBoundedIndex( visibleRect.top(), dy, d.rowCount() );
+    const int rowMax = qskBoundedIndex( visibleRect.bottom(), dy, d.rowCount() );
+
+    // recycling the items, that have left the visible area
+
+    for ( auto it = d.items.begin(); it != d.items.end(); )
+    {
+        const int index = it.key();
+
+        const int row = index / d.dimension;
+        const int col = index % d.dimension;
+
+        if ( index >= d.count || row < rowMin || row > rowMax
+            || col < colMin || col > colMax )
+        {
+            it.value()->setVisible( false );
+            d.pool += it.value();
+
+            it = d.items.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // instantiating the items, that have entered the visible area
+
+    bool isDirty = false;
+
+    for ( int row = rowMin; row <= rowMax; row++ )
+    {
+        for ( int col = colMin; col <= colMax; col++ )
+        {
+            const int index = row * d.dimension + col;
+            if ( index >= d.count )
+                break;
+
+            auto item = d.items.value( index, nullptr );
+            if ( item == nullptr )
+            {
+                item = d.takeItem( this );
+                if ( item == nullptr )
+                    continue;
+
+                if ( d.binder )
+                    d.binder( item, index );
+
+                item->setVisible( true );
+                d.items.insert( index, item );
+
+                isDirty = true;
+            }
+
+            qskSetItemGeometry( item, cellRect( index ) );
+        }
+    }
+
+    /*
+        Without trimming the pool would grow to the maximum of
+        items, that have ever been visible at the same time.
+     */
+    while ( d.pool.count() > d.items.count() )
+        delete d.pool.takeLast();
+
+    if ( isDirty )
+    {
+        // restoring the order of the tab focus chain
+
+        auto indexes = d.items.keys();
+        std::sort( indexes.begin(), indexes.end() );
+
+        QVector< QQuickItem* > items;
+        items.reserve( indexes.count() );
+
+        for ( const auto index : qAsConst( indexes ) )
+            items += d.items[ index ];
+
+        qskRestackChildItems( this, items );
+    }
+}
+
+QSizeF QskVirtualGridBox::layoutSizeHint(
+    Qt::SizeHint which, const QSizeF& constraint ) const
+{
+    if ( which == Qt::MaximumSize )
+        return Inherited::layoutSizeHint( which, constraint );
+
+    const auto& d = *m_data;
+
+    if ( d.count <= 0 )
+        return QSizeF( 0.0, 0.0 );
+
+    const int columns = qMin( d.count, d.dimension );
+    const int rows = d.rowCount();
+
+    const qreal w = columns * d.cellSize.width() + ( columns - 1 ) * d.spacing;
+    const qreal h = rows * d.cellSize.height() + ( rows - 1 ) * d.spacing;
+
+    return QSizeF( w, h );
+}
+
+#include "moc_QskVirtualGridBox.cpp"
@@ -0,0 +1,108 @@
+/******************************************************************************
+ * QSkinny - Copyright (C) 2016 Uwe Rathmann
+ * This file may be used under the terms of the QSkinny License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QSK_VIRTUAL_GRID_BOX_H
+#define QSK_VIRTUAL_GRID_BOX_H
+
+#include "QskBox.h"
+#include <functional>
+
+/*
+    A grid of cells with the same size, where items are only instantiated
+    for the cells intersecting the visible part of the box. Items leaving
+    the visible area are recycled for the cells becoming visible,
+    so that the number of items ( and scene graph nodes ) depends on
+    the size of the viewport and not on the number of cells.
+
+    The visible area is taken from the QskScrollBox ( f.e QskScrollArea ),
+    the box has been put into - or the window, when there is none.
+ */
+
+class QSK_EXPORT QskVirtualGridBox : public QskBox
+{
+    Q_OBJECT
+
+    Q_PROPERTY( int count READ count
+        WRITE setCount NOTIFY countChanged FINAL )
+
+    Q_PROPERTY( int dimension READ dimension
+        WRITE setDimension NOTIFY dimensionChanged FINAL )
+
+    Q_PROPERTY( QSizeF cellSize READ cellSize
+        WRITE setCellSize NOTIFY cellSizeChanged FINAL )
+
+    Q_PROPERTY( qreal spacing READ spacing
+        WRITE setSpacing RESET resetSpacing NOTIFY spacingChanged FINAL )
+
+    Q_PROPERTY( qreal overscan READ overscan
+        WRITE setOverscan NOTIFY overscanChanged FINAL )
+
+    using Inherited = QskBox;
+
+  public:
+    // creating an item, that can be used for any cell
+    using ItemFactory = std::function< QQuickItem*() >;
+
+    // assigning the contents of a cell to a new or recycled item
+    using ItemBinder = std::function< void( QQuickItem*, int index ) >;
+
+    explicit QskVirtualGridBox( QQuickItem* parent = nullptr );
+    ~QskVirtualGridBox() override;
+
+    void setDelegate( const ItemFactory&, const ItemBinder& );
+
+    void setCount( int );
+    int count() const;
+
+    // number of columns
+    void setDimension( int );
+    int dimension() const;
+
+    void setCellSize( const QSizeF& );
+    QSizeF cellSize() const;
+
+    void setSpacing( qreal );
+    void resetSpacing();
+    qreal spacing() const;
+
+    // extra space around the viewport, where items are instantiated in advance
+    void setOverscan( qreal );
+    qreal overscan() const;
+
+    QRectF cellRect( int index ) const;
+    QRectF viewport() const;
+
+    QQuickItem* itemAtIndex( int index ) const;
+    int indexOf( const QQuickItem* ) const;
+
+    int instantiatedCount() const;
+
+  public Q_SLOTS:
+    // rebinding the instantiated items, after the contents of the cells have changed
+    void reload();
+
+  Q_SIGNALS:
+    void countChanged( int );
+    void dimensionChanged( int );
+    void cellSizeChanged( const QSizeF& );
+    void spacingChanged( qreal );
+    void overscanChanged( qreal );
+
+  protected:
+    void geometryChangeEvent( QskGeometryChangeEvent* ) override;
+    void itemChange( ItemChange, const ItemChangeData& ) override;
+
+    void updateLayout() override;
+    QSizeF layoutSizeHint( Qt::SizeHint, const QSizeF& ) const override;
+
+  private:
+    void updateViewportConnections();
+    void recycleItems();
+
+    class PrivateData;
+    std::unique_ptr< PrivateData > m_data;
+};
+
+#endif
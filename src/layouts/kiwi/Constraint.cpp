@@ -3,6 +3,9 @@
 
 #include <map>
 
+namespace QskKiwi
+{
+
 static Expression reduce( const Expression& expr )
 {
     std::map< Variable, double > vars;
@@ -283,3 +286,5 @@ Constraint operator>=( double constant, const Variable& variable )
 {
     return variable <= constant;
 }
+
+}
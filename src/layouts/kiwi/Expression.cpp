@@ -1,6 +1,9 @@
 #include "Expression.h"
 #include "Term.h"
 
+namespace QskKiwi
+{
+
 Expression::Expression( double constant )
     : m_constant( constant )
 {
@@ -224,3 +227,5 @@ Expression operator-( double constant, const Variable& variable )
 {
     return -variable + constant;
 }
+
+}
@@ -3,6 +3,9 @@
 #include <vector>
 #include "Term.h"
 
+namespace QskKiwi
+{
+
 class Expression
 {
   public:
@@ -66,3 +69,4 @@ extern Expression operator-( const Variable&, double );
 extern Expression operator+( double, const Variable& );
 extern Expression operator-( double, const Variable& );
 
+}
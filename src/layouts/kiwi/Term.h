@@ -3,6 +3,9 @@
 #include <utility>
 #include "Variable.h"
 
+namespace QskKiwi
+{
+
 class Term
 {
   public:
@@ -79,3 +82,5 @@ inline Term operator*( double coefficient, const Variable& variable )
 {
     return variable * coefficient;
 }
+
+}
@@ -2,6 +2,9 @@
 
 #include <memory>
 
+namespace QskKiwi
+{
+
 class Variable
 {
   public:
@@ -44,3 +47,5 @@ class Variable
         return lhs.m_value < rhs.m_value;
     }
 };
+
+}
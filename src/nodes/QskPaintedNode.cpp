@@ -11,6 +11,7 @@
 #include <qquickwindow.h>
 #include <qimage.h>
 #include <qpainter.h>
+#include <qmath.h>
 
 QSK_QT_PRIVATE_BEGIN
 #include <private/qsgplaintexture_p.h>
@@ -30,6 +31,28 @@ static inline QSGImageNode::TextureCoordinatesTransformMode
     return mode;
 }
 
+static inline QSize qskMipmapSize( const QSize& size )
+{
+    // rounding up to the next power of 2
+
+    const auto w = qNextPowerOfTwo( quint32( qMax( size.width(), 1 ) - 1 ) );
+    const auto h = qNextPowerOfTwo( quint32( qMax( size.height(), 1 ) - 1 ) );
+
+    return QSize( static_cast< int >( w ), static_cast< int >( h ) );
+}
+
+static inline bool qskIsMipmapValid( const QSize& textureSize, const QSize& size )
+{
+    /*
+        Downscaling is done by the mipmaps, but we don't want
+        to waste too much memory for textures, that have shrunk
+     */
+    return ( textureSize.width() >= size.width() )
+        && ( textureSize.height() >= size.height() )
+        && ( textureSize.width() <= 4 * qMax( size.width(), 1 ) )
+        && ( textureSize.height() <= 4 * qMax( size.height(), 1 ) );
+}
+
 namespace
 {
     const quint8 imageRole = 250; // reserved for internal use
@@ -41,6 +64,25 @@ namespace
 
         return static_cast< QSGImageNode* >( node );
     }
+
+    class PaintHelper : public QskTextureRenderer::PaintHelper
+    {
+      public:
+        PaintHelper( QskPaintedNode* node, const void* nodeData )
+            : m_node( node )
+            , m_nodeData( nodeData )
+        {
+        }
+
+        void paint( QPainter* painter, const QSize& size ) override
+        {
+            m_node->paint( painter, size, m_nodeData );
+        }
+
+      private:
+        QskPaintedNode* m_node;
+        const void* m_nodeData;
+    };
 }
 
 QskPaintedNode::QskPaintedNode()
@@ -49,6 +91,7 @@ QskPaintedNode::QskPaintedNode()
 
 QskPaintedNode::~QskPaintedNode()
 {
+    QskTextureRenderer::releasePooledFboGL( m_fbo );
 }
 
 void QskPaintedNode::setRenderHint( RenderHint renderHint )
@@ -80,12 +123,28 @@ Qt::Orientations QskPaintedNode::mirrored() const
     return m_mirrored;
 }
 
+void QskPaintedNode::setMipmapped( bool on )
+{
+    if ( on != m_mipmapped )
+    {
+        m_mipmapped = on;
+        m_hash = 0; // forcing a new texture
+    }
+}
+
+bool QskPaintedNode::isMipmapped() const
+{
+    return m_mipmapped;
+}
+
 QSize QskPaintedNode::textureSize() const
 {
+    // textures from the FBO pool are usually larger than the painted area
+
     if ( const auto imageNode = findImageNode( this ) )
     {
-        if ( auto texture = imageNode->texture() )
-            return texture->textureSize();
+        if ( imageNode->texture() )
+            return imageNode->sourceRect().size().toSize();
     }
 
     return QSize();
@@ -110,6 +169,9 @@ void QskPaintedNode::update( QQuickWindow* window,
             delete imageNode;
         }
 
+        QskTextureRenderer::releasePooledFboGL( m_fbo );
+        m_fbo = nullptr;
+
         return;
     }
 
@@ -126,10 +188,20 @@ void QskPaintedNode::update( QQuickWindow* window,
     QSize imageSize;
 
     {
+        // the texture is measured in device pixels
         auto scaledSize = size.isEmpty() ? rect.size() : size;
         scaledSize *= window->effectiveDevicePixelRatio();
 
-        imageSize = scaledSize.toSize();
+        if ( m_mipmapped )
+        {
+            // the texture has to cover all device pixels
+            imageSize = QSize( qCeil( scaledSize.width() ),
+                qCeil( scaledSize.height() ) );
+        }
+        else
+        {
+            imageSize = scaledSize.toSize();
+        }
     }
 
     bool isTextureDirty = false;
@@ -140,14 +212,31 @@ void QskPaintedNode::update( QQuickWindow* window,
         m_hash = newHash;
         isTextureDirty = true;
     }
+    else if ( m_mipmapped )
+    {
+        isTextureDirty = !qskIsMipmapValid( textureSize(), imageSize );
+    }
     else
     {
         isTextureDirty = ( imageSize != textureSize() );
     }
 
-
     if ( isTextureDirty )
+    {
+        if ( m_mipmapped )
+        {
+            /*
+                Rasterizing into power of 2 levels of device pixels, so
+                that scaling within a level needs no rasterization
+             */
+            imageSize = qskMipmapSize( imageSize );
+        }
+
         updateTexture( window, imageSize, nodeData );
+    }
+
+    imageNode->setMipmapFiltering(
+        m_mipmapped ? QSGTexture::Linear : QSGTexture::None );
 
     imageNode->setRect( rect );
     imageNode->setTextureCoordinatesTransform(
@@ -159,77 +248,67 @@ void QskPaintedNode::updateTexture( QQuickWindow* window,
 {
     auto imageNode = findImageNode( this );
 
-    if ( ( m_renderHint == OpenGL ) && QskTextureRenderer::isOpenGLWindow( window ) )
+    /*
+        Mipmaps are generated by the scene graph for textures from images,
+        but FBO textures would be wrapped without them.
+     */
+    const bool useFbo = ( m_renderHint == OpenGL ) && !m_mipmapped
+        && QskTextureRenderer::isOpenGLWindow( window );
+
+    if ( useFbo )
     {
-        const auto textureId = createTextureGL( window, size, nodeData );
+        // a texture created from an image can't be used for the FBO
+
+        QSGPlainTexture* texture = nullptr;
+        if ( m_fbo )
+            texture = qobject_cast< QSGPlainTexture* >( imageNode->texture() );
+
+        paintFboGL( window, size, nodeData );
 
-        auto texture = qobject_cast< QSGPlainTexture* >( imageNode->texture() );
         if ( texture == nullptr )
         {
             texture = new QSGPlainTexture;
             texture->setHasAlphaChannel( true );
-            texture->setOwnsTexture( true );
 
             imageNode->setTexture( texture );
         }
 
-        QskTextureRenderer::setTextureId( window, textureId, size, texture );
+        QskTextureRenderer::setFboTexture( window, m_fbo, texture );
     }
     else
     {
-        const auto image = createImage( window, size, nodeData );
+        /*
+            Images are taken from a pool, where they are bucketed like
+            the FBOs. So the texture keeps its size and can be updated
+            in place as long as the size stays in the same bucket.
+            Mipmapped images are already rounded to powers of 2.
+         */
+        PaintHelper helper( this, nodeData );
 
-        if ( auto texture = qobject_cast< QSGPlainTexture* >( imageNode->texture() ) )
-            texture->setImage( image );
-        else
-            imageNode->setTexture( window->createTextureFromImage( image ) );
-    }
-}
+        const auto image = QskTextureRenderer::paintPooledImage(
+            window, size, &helper, m_mipmapped );
 
-QImage QskPaintedNode::createImage( QQuickWindow* window,
-    const QSize& size, const void* nodeData )
-{
-    QImage image( size, QImage::Format_RGBA8888_Premultiplied );
-    image.fill( Qt::transparent );
+        // a texture wrapping the FBO can't be reused
+        auto texture = m_fbo ? nullptr : imageNode->texture();
 
-    QPainter painter( &image );
+        texture = QskTextureRenderer::setTextureImage(
+            window, image, m_mipmapped, texture );
 
-    /*
-        setting a devicePixelRatio for the image only works for
-        value >= 1.0. So we have to scale manually.
-     */
-    const auto ratio = window->effectiveDevicePixelRatio();
-    painter.scale( ratio, ratio );
+        if ( texture != imageNode->texture() )
+            imageNode->setTexture( texture );
 
-    paint( &painter, size / ratio, nodeData );
+        QskTextureRenderer::releasePooledImage( image );
 
-    painter.end();
+        QskTextureRenderer::releasePooledFboGL( m_fbo );
+        m_fbo = nullptr;
+    }
 
-    return image;
+    imageNode->setSourceRect( 0, 0, size.width(), size.height() );
 }
 
-quint32 QskPaintedNode::createTextureGL(
+void QskPaintedNode::paintFboGL(
     QQuickWindow* window, const QSize& size, const void* nodeData )
 {
-    class PaintHelper : public QskTextureRenderer::PaintHelper
-    {
-      public:
-        PaintHelper( QskPaintedNode* node, const void* nodeData )
-            : m_node( node )
-            , m_nodeData( nodeData )
-        {
-        }
-
-        void paint( QPainter* painter, const QSize& size ) override
-        {
-            m_node->paint( painter, size, m_nodeData );
-        }
-
-      private:
-        QskPaintedNode* m_node;
-        const void* m_nodeData;
-    };
-
     PaintHelper helper( this, nodeData );
-    return createPaintedTextureGL( window, size, &helper );
+    m_fbo = QskTextureRenderer::paintPooledFboGL( window, size, &helper, m_fbo );
 }
@@ -11,7 +11,7 @@
 
 class QQuickWindow;
 class QPainter;
-class QImage;
+class QOpenGLFramebufferObject;
 
 class QSK_EXPORT QskPaintedNode : public QSGNode
 {
@@ -42,6 +42,14 @@ class QSK_EXPORT QskPaintedNode : public QSGNode
     void setMirrored( Qt::Orientations );
     Qt::Orientations mirrored() const;
 
+    /*
+        A mipmapped texture is rasterized in power of 2 sizes, so that
+        it can be scaled without being rasterized again. Intended for
+        nodes, that are scaled by animations.
+     */
+    void setMipmapped( bool );
+    bool isMipmapped() const;
+
     QRectF rect() const;
     QSize textureSize() const;
 
@@ -56,11 +64,14 @@ class QSK_EXPORT QskPaintedNode : public QSGNode
   private:
     void updateTexture( QQuickWindow*, const QSize&, const void* nodeData );
 
-    QImage createImage( QQuickWindow*, const QSize&, const void* nodeData );
-    quint32 createTextureGL( QQuickWindow*, const QSize&, const void* nodeData );
+    void paintFboGL( QQuickWindow*, const QSize&, const void* nodeData );
+
+    // from the FBO pool of QskTextureRenderer
+    QOpenGLFramebufferObject* m_fbo = nullptr;
 
     RenderHint m_renderHint = OpenGL;
     Qt::Orientations m_mirrored;
+    bool m_mipmapped = false;
     QskHashValue m_hash = 0;
 };
 
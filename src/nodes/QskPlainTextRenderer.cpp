@@ -7,9 +7,16 @@
 #include "QskTextColors.h"
 #include "QskTextOptions.h"
 
+#include <qatomic.h>
+#include <qcache.h>
 #include <qfontmetrics.h>
+#include <qglyphrun.h>
+#include <qhash.h>
 #include <qmath.h>
 #include <qsgnode.h>
+#include <qthreadstorage.h>
+
+#include <algorithm>
 
 QSK_QT_PRIVATE_BEGIN
 #include <private/qsgadaptationlayer_p.h>
@@ -19,6 +26,122 @@ QSK_QT_PRIVATE_END
 
 #define GlyphFlag static_cast< QSGNode::Flag >( 0x800 )
 
+namespace
+{
+    /*
+        The result of shaping a text: the glyph runs of all lines,
+        positioned for a specific width
+     */
+    class GlyphRunsKey
+    {
+      public:
+        inline bool operator==( const GlyphRunsKey& other ) const
+        {
+            return ( width == other.width ) && ( alignment == other.alignment )
+                && ( options == other.options ) && ( font == other.font )
+                && ( text == other.text );
+        }
+
+        QString text;
+        QFont font;
+        QskTextOptions options;
+        int alignment;
+        qreal width;
+    };
+
+    inline QskHashValue qHash( const GlyphRunsKey& key, QskHashValue seed = 0 )
+    {
+        auto hash = ::qHash( key.text, seed );
+        hash = ::qHash( key.font, hash );
+        hash = key.options.hash( hash );
+        hash = ::qHash( key.alignment, hash );
+        hash = qHashBits( &key.width, sizeof( key.width ), hash );
+
+        return hash;
+    }
+
+    class GlyphRuns
+    {
+      public:
+        QVector< QGlyphRun > runs;
+
+        qreal textHeight = 0.0;
+        qreal boundingHeight = 0.0;
+    };
+
+    /*
+        Font engines are cached per thread, so we better don't
+        share glyph runs between different render threads.
+        The cost of an entry is the number of its glyphs.
+     */
+    using GlyphRunsCache = QCache< GlyphRunsKey, GlyphRuns >;
+
+    /*
+        A text shaped once in a single line without any width limit.
+        Elided versions for different widths are composed from the glyph
+        runs of subranges of it, so that we don't need to shape the
+        elided string again.
+     */
+    class ShapedLine
+    {
+      public:
+        class Cut
+        {
+          public:
+            int from; // end of the left part
+            int to;   // start of the right part
+        };
+
+        QTextLayout layout;
+        QTextLayout ellipsisLayout;
+
+        // x coordinates for all cursor positions
+        QVector< qreal > xPositions;
+
+        // the same heights as being calculated, when reshaping the text
+        qreal lineHeight = 0.0;
+        qreal boundingHeight = 0.0;
+
+        qreal ellipsisWidth = 0.0;
+
+        // cut positions for elide mode and width ( in pixels )
+        QHash< QPair< int, int >, Cut > cuts;
+    };
+
+    class ShapedLineKey
+    {
+      public:
+        inline bool operator==( const ShapedLineKey& other ) const
+        {
+            return ( font == other.font ) && ( text == other.text );
+        }
+
+        QString text;
+        QFont font;
+    };
+
+    inline QskHashValue qHash( const ShapedLineKey& key, QskHashValue seed = 0 )
+    {
+        return ::qHash( key.font, ::qHash( key.text, seed ) );
+    }
+
+    using ShapedLineCache = QCache< ShapedLineKey, ShapedLine >;
+}
+
+static QAtomicInt qskGlyphCacheSize( 20000 );
+static QThreadStorage< GlyphRunsCache* > qskGlyphRunsCaches;
+static QThreadStorage< ShapedLineCache* > qskShapedLineCaches;
+
+void QskPlainTextRenderer::setGlyphCacheSize( int size )
+{
+    qskGlyphCacheSize.storeRelaxed( qMax( size, 0 ) );
+}
+
+int QskPlainTextRenderer::glyphCacheSize()
+{
+    return qskGlyphCacheSize.loadRelaxed();
+}
+
 QSizeF QskPlainTextRenderer::textSize(
     const QString& text, const QFont& font, const QskTextOptions& options )
 {
@@ -96,9 +219,227 @@ static qreal qskLayoutText( QTextLayout* layout,
     return y;
 }
 
+static inline bool qskCanElideFast( const QString& text )
+{
+    /*
+        The x coordinates of the cursor positions are increasing for
+        simple left-to-right texts only. Everything else is elided
+        by QTextEngine.
+     */
+    return !text.isEmpty() && text.isSimpleText()
+        && !text.contains( QChar::LineSeparator );
+}
+
+static void qskInitLayout( QTextLayout& layout, const QString& text, const QFont& font )
+{
+    QTextOption textOption( Qt::AlignLeft );
+    textOption.setWrapMode( QTextOption::NoWrap );
+
+    layout.setFont( font );
+    layout.setTextOption( textOption );
+    layout.setText( text );
+
+    layout.beginLayout();
+    ( void ) layout.createLine();
+    layout.endLayout();
+}
+
+static ShapedLine* qskShapedLine( const QString& text, const QFont& font )
+{
+    if ( !qskShapedLineCaches.hasLocalData() )
+    {
+        auto cache = new ShapedLineCache();
+        cache->setMaxCost( 500 ); // number of texts
+
+        qskShapedLineCaches.setLocalData( cache );
+    }
+
+    auto cache = qskShapedLineCaches.localData();
+
+    ShapedLineKey key;
+    key.text = text;
+    key.font = font;
+
+    if ( auto shapedLine = cache->object( key ) )
+        return shapedLine;
+
+    auto shapedLine = new ShapedLine();
+
+    qskInitLayout( shapedLine->layout, text, font );
+    qskInitLayout( shapedLine->ellipsisLayout, QString( QChar( 0x2026 ) ), font );
+
+    const auto line = shapedLine->layout.lineAt( 0 );
+
+    shapedLine->lineHeight = line.leading() + line.height();
+    shapedLine->boundingHeight = shapedLine->layout.boundingRect().height();
+    shapedLine->ellipsisWidth =
+        shapedLine->ellipsisLayout.lineAt( 0 ).naturalTextWidth();
+
+    auto& xPositions = shapedLine->xPositions;
+    xPositions.reserve( text.size() + 1 );
+
+    for ( int i = 0; i <= text.size(); i++ )
+        xPositions += line.cursorToX( i );
+
+    cache->insert( key, shapedLine );
+    return shapedLine;
+}
+
+static ShapedLine::Cut qskCut( const ShapedLine& shapedLine,
+    Qt::TextElideMode elideMode, qreal width )
+{
+    const auto& x = shapedLine.xPositions;
+
+    const int count = x.size() - 1;
+    const qreal textWidth = x[ count ];
+    const qreal available = width - shapedLine.ellipsisWidth;
+
+    const auto isValid = [ &shapedLine ]( int pos )
+        { return shapedLine.layout.isValidCursorPosition( pos ); };
+
+    // the first position with x[pos] > value
+    const auto upperBound = [ &x ]( qreal value )
+        { return int( std::upper_bound( x.constBegin(), x.constEnd(), value ) - x.constBegin() ); };
+
+    // the first position with x[pos] >= value
+    const auto lowerBound = [ &x ]( qreal value )
+        { return int( std::lower_bound( x.constBegin(), x.constEnd(), value ) - x.constBegin() ); };
+
+    ShapedLine::Cut cut { 0, count };
+
+    switch ( elideMode )
+    {
+        case Qt::ElideRight:
+        {
+            cut.from = qMax( upperBound( available ) - 1, 0 );
+            while ( cut.from > 0 && !isValid( cut.from ) )
+                cut.from--;
+
+            break;
+        }
+        case Qt::ElideLeft:
+        {
+            cut.to = qMin( lowerBound( textWidth - available ), count );
+            while ( cut.to < count && !isValid( cut.to ) )
+                cut.to++;
+
+            break;
+        }
+        case Qt::ElideMiddle:
+        {
+            cut.from = qMax( upperBound( 0.5 * available ) - 1, 0 );
+            while ( cut.from > 0 && !isValid( cut.from ) )
+                cut.from--;
+
+            const qreal right = available - x[ cut.from ];
+
+            cut.to = qBound( cut.from, lowerBound( textWidth - right ), count );
+            while ( cut.to < count && !isValid( cut.to ) )
+                cut.to++;
+
+            break;
+        }
+        default:
+            break;
+    }
+
+    return cut;
+}
+
+static void qskAppendRuns( QVector< QGlyphRun >& runs,
+    const QTextLine& line, int from, int length, qreal dx )
+{
+    if ( length <= 0 )
+        return;
+
+    auto glyphRuns = line.glyphRuns( from, length );
+
+    for ( auto& glyphRun : glyphRuns )
+    {
+        if ( dx != 0.0 )
+        {
+            auto positions = glyphRun.positions();
+            for ( auto& pos : positions )
+                pos.rx() += dx;
+
+            glyphRun.setPositions( positions );
+        }
+
+        runs += glyphRun;
+    }
+}
+
+static void qskElideFast( const QString& text, const QFont& font,
+    Qt::TextElideMode elideMode, Qt::Alignment alignment, qreal width,
+    GlyphRuns& glyphRuns )
+{
+    const auto shapedLine = qskShapedLine( text, font );
+
+    const auto& x = shapedLine->xPositions;
+    const int count = x.size() - 1;
+
+    glyphRuns.textHeight = shapedLine->lineHeight;
+    glyphRuns.boundingHeight = shapedLine->boundingHeight;
+
+    auto& runs = glyphRuns.runs;
+
+    const auto line = shapedLine->layout.lineAt( 0 );
+
+    if ( x[ count ] <= width )
+    {
+        // no need to elide
+        qreal dx = 0.0;
+
+        if ( alignment & Qt::AlignRight )
+            dx = width - x[ count ];
+        else if ( alignment & Qt::AlignHCenter )
+            dx = 0.5 * ( width - x[ count ] );
+
+        qskAppendRuns( runs, line, 0, count, dx );
+        return;
+    }
+
+    /*
+        Widths of a resized column are changing in subpixel steps, but
+        most of the time the cut positions do not change with them.
+        So we cache the cut positions for the width rounded down.
+     */
+    const int bucket = qFloor( width );
+    const QPair< int, int > cutKey( elideMode, bucket );
+
+    auto& cuts = shapedLine->cuts;
+
+    auto it = cuts.constFind( cutKey );
+    if ( it == cuts.constEnd() )
+    {
+        if ( cuts.size() > 50 )
+            cuts.clear();
+
+        it = cuts.insert( cutKey, qskCut( *shapedLine, elideMode, bucket ) );
+    }
+
+    const auto cut = it.value();
+
+    const qreal ellipsisX = x[ cut.from ];
+    const qreal rightShift = ellipsisX + shapedLine->ellipsisWidth - x[ cut.to ];
+    const qreal elidedWidth = x[ count ] + rightShift;
+
+    qreal dx = 0.0;
+
+    if ( alignment & Qt::AlignRight )
+        dx = width - elidedWidth;
+    else if ( alignment & Qt::AlignHCenter )
+        dx = 0.5 * ( width - elidedWidth );
+
+    qskAppendRuns( runs, line, 0, cut.from, dx );
+    qskAppendRuns( runs, shapedLine->ellipsisLayout.lineAt( 0 ), 0, 1, dx + ellipsisX );
+    qskAppendRuns( runs, line, cut.to, count - cut.to, dx + rightShift );
+}
+
 static void qskRenderText(
-    QQuickItem* item, QSGNode* parentNode, const QTextLayout& layout, qreal baseLine,
-    const QColor& color, QQuickText::TextStyle style, const QColor& styleColor )
+    QQuickItem* item, QSGNode* parentNode, const QVector< QGlyphRun >& glyphRuns,
+    qreal baseLine, const QColor& color, QQuickText::TextStyle style,
+    const QColor& styleColor )
 {
     auto renderContext = QQuickItemPrivate::get(item)->sceneGraphRenderContext();
     auto sgContext = renderContext->sceneGraphContext();
@@ -120,39 +461,34 @@ static void qskRenderText(
 
     const QPointF position( 0, baseLine );
 
-    for ( int i = 0; i < layout.lineCount(); ++i )
+    for ( const auto& glyphRun : glyphRuns )
     {
-        const auto glyphRuns = layout.lineAt( i ).glyphRuns();
-
-        for ( const auto& glyphRun : glyphRuns )
+        if ( glyphNode == nullptr )
         {
-            if ( glyphNode == nullptr )
-            {
-                const bool preferNativeGlyphNode = false; // QskTextOptions?
+            const bool preferNativeGlyphNode = false; // QskTextOptions?
 
 #if QT_VERSION >= QT_VERSION_CHECK( 6, 0, 0 )
-                constexpr int renderQuality = -1; // QQuickText::DefaultRenderTypeQuality
-                glyphNode = sgContext->createGlyphNode(
-                    renderContext, preferNativeGlyphNode, renderQuality );
+            constexpr int renderQuality = -1; // QQuickText::DefaultRenderTypeQuality
+            glyphNode = sgContext->createGlyphNode(
+                renderContext, preferNativeGlyphNode, renderQuality );
 #else
-                glyphNode = sgContext->createGlyphNode(
-                    renderContext, preferNativeGlyphNode );
+            glyphNode = sgContext->createGlyphNode(
+                renderContext, preferNativeGlyphNode );
 #endif
-                glyphNode->setOwnerElement( item );
-                glyphNode->setFlags( QSGNode::OwnedByParent | GlyphFlag );
-            }
+            glyphNode->setOwnerElement( item );
+            glyphNode->setFlags( QSGNode::OwnedByParent | GlyphFlag );
+        }
 
-            glyphNode->setStyle( style );
-            glyphNode->setColor( color );
-            glyphNode->setStyleColor( styleColor );
-            glyphNode->setGlyphs( position, glyphRun );
-            glyphNode->update();
+        glyphNode->setStyle( style );
+        glyphNode->setColor( color );
+        glyphNode->setStyleColor( styleColor );
+        glyphNode->setGlyphs( position, glyphRun );
+        glyphNode->update();
 
-            if ( glyphNode->parent() != parentNode )
-                parentNode->appendChildNode( glyphNode );
+        if ( glyphNode->parent() != parentNode )
+            parentNode->appendChildNode( glyphNode );
 
-            glyphNode = static_cast< QSGGlyphNode* >( glyphNode->nextSibling() );
-        }
+        glyphNode = static_cast< QSGGlyphNode* >( glyphNode->nextSibling() );
     }
 
     // Remove leftover glyphs
@@ -168,11 +504,8 @@ static void qskRenderText(
     }
 }
 
-void QskPlainTextRenderer::updateNode( const QString& text,
-    const QFont& font, const QskTextOptions& options,
-    Qsk::TextStyle style, const QskTextColors& colors,
-    Qt::Alignment alignment, const QRectF& rect,
-    const QQuickItem* item, QSGTransformNode* node )
+static GlyphRuns qskShapeText( const QString& text, const QFont& font,
+    const QskTextOptions& options, Qt::Alignment alignment, qreal width )
 {
     QTextOption textOption( alignment );
     textOption.setWrapMode( static_cast< QTextOption::WrapMode >( options.wrapMode() ) );
@@ -195,6 +528,15 @@ void QskPlainTextRenderer::updateNode( const QString& text,
         tmp.replace( QLatin1Char('\n'), QChar::LineSeparator );
     }
 
+    GlyphRuns glyphRuns;
+
+    const auto elideMode = options.effectiveElideMode();
+
+    if ( elideMode != Qt::ElideNone && qskCanElideFast( tmp ) )
+    {
+        qskElideFast( tmp, font, elideMode, alignment, width, glyphRuns );
+        return glyphRuns;
+    }
 
     QTextLayout layout;
     layout.setFont( font );
@@ -202,20 +544,67 @@ void QskPlainTextRenderer::updateNode( const QString& text,
     layout.setText( tmp );
 
     layout.beginLayout();
-    const qreal textHeight = qskLayoutText( &layout, rect.width(), options );
+    glyphRuns.textHeight = qskLayoutText( &layout, width, options );
     layout.endLayout();
 
+    glyphRuns.boundingHeight = layout.boundingRect().height();
+
+    for ( int i = 0; i < layout.lineCount(); ++i )
+        glyphRuns.runs += layout.lineAt( i ).glyphRuns();
+
+    return glyphRuns;
+}
+
+static GlyphRuns qskGlyphRuns( const QString& text, const QFont& font,
+    const QskTextOptions& options, Qt::Alignment alignment, qreal width )
+{
+    const int maxCost = qskGlyphCacheSize.loadRelaxed();
+    if ( maxCost <= 0 )
+        return qskShapeText( text, font, options, alignment, width );
+
+    if ( !qskGlyphRunsCaches.hasLocalData() )
+        qskGlyphRunsCaches.setLocalData( new GlyphRunsCache() );
+
+    auto cache = qskGlyphRunsCaches.localData();
+    if ( cache->maxCost() != maxCost )
+        cache->setMaxCost( maxCost );
+
+    GlyphRunsKey key;
+    key.text = text;
+    key.font = font;
+    key.options = options;
+    key.alignment = alignment & Qt::AlignHorizontal_Mask;
+    key.width = width;
+
+    if ( const auto glyphRuns = cache->object( key ) )
+        return *glyphRuns;
+
+    const auto glyphRuns = qskShapeText( text, font, options, alignment, width );
+
+    int cost = 1;
+    for ( const auto& run : glyphRuns.runs )
+        cost += run.glyphIndexes().size();
+
+    if ( cost <= maxCost )
+        cache->insert( key, new GlyphRuns( glyphRuns ), cost );
+
+    return glyphRuns;
+}
+
+static qreal qskBaseline( const GlyphRuns& glyphRuns,
+    const QFont& font, Qt::Alignment alignment, qreal height )
+{
     const qreal y0 = QFontMetricsF( font ).ascent();
 
     qreal yBaseline = y0;
 
     if ( alignment & Qt::AlignVCenter )
     {
-        yBaseline += ( rect.height() - textHeight ) * 0.5;
+        yBaseline += ( height - glyphRuns.textHeight ) * 0.5;
     }
     else if ( alignment & Qt::AlignBottom )
     {
-        yBaseline += rect.height() - textHeight;
+        yBaseline += height - glyphRuns.textHeight;
     }
 
     if ( yBaseline != y0 )
@@ -226,16 +615,49 @@ void QskPlainTextRenderer::updateNode( const QString& text,
             between margins/paddings.
          */
 
-        const int bh = int( layout.boundingRect().height() );
+        const int bh = int( glyphRuns.boundingHeight );
         yBaseline = ( bh % 2 ) ? qFloor( yBaseline ) : qCeil( yBaseline );
     }
 
+    return yBaseline;
+}
+
+void QskPlainTextRenderer::updateNode( const QString& text,
+    const QFont& font, const QskTextOptions& options,
+    Qsk::TextStyle style, const QskTextColors& colors,
+    Qt::Alignment alignment, const QRectF& rect,
+    const QQuickItem* item, QSGTransformNode* node )
+{
+    /*
+        Nodes of lists are recycled and the same texts are shaped
+        over and over again. So we cache the glyph runs.
+     */
+    const auto glyphRuns = qskGlyphRuns(
+        text, font, options, alignment, rect.width() );
+
+    const auto yBaseline = qskBaseline(
+        glyphRuns, font, alignment, rect.height() );
+
     qskRenderText(
-        const_cast< QQuickItem* >( item ), node, layout, yBaseline,
+        const_cast< QQuickItem* >( item ), node, glyphRuns.runs, yBaseline,
         colors.textColor, static_cast< QQuickText::TextStyle >( style ),
         colors.styleColor );
 }
 
+qreal QskPlainTextRenderer::verticalOffset( const QString& text,
+    const QFont& font, const QskTextOptions& options,
+    Qt::Alignment alignment, const QSizeF& size )
+{
+    if ( !( alignment & ( Qt::AlignVCenter | Qt::AlignBottom ) ) )
+        return 0.0;
+
+    const auto glyphRuns = qskGlyphRuns(
+        text, font, options, alignment, size.width() );
+
+    return qskBaseline( glyphRuns, font, alignment, size.height() )
+        - QFontMetricsF( font ).ascent();
+}
+
 void QskPlainTextRenderer::updateNodeColor(
     QSGNode* parentNode, const QColor& textColor,
     Qsk::TextStyle style, const QColor& styleColor )
@@ -28,6 +28,13 @@ namespace QskPlainTextRenderer
         Qsk::TextStyle, const QskTextColors&, Qt::Alignment, const QRectF&,
         const QQuickItem*, QSGTransformNode* );
 
+    /*
+        The vertical translation of a text, that has been rendered
+        by updateNode with Qt::AlignTop, to match the alignment.
+     */
+    QSK_EXPORT qreal verticalOffset( const QString&, const QFont&,
+        const QskTextOptions&, Qt::Alignment, const QSizeF& );
+
     QSK_EXPORT void updateNodeColor(
         QSGNode* parentNode, const QColor& textColor,
         Qsk::TextStyle, const QColor& styleColor );
@@ -37,6 +44,13 @@ namespace QskPlainTextRenderer
 
     QSK_EXPORT QRectF textRect( const QString&,
         const QFont&, const QskTextOptions&, const QSizeF& );
+
+    /*
+        Shaped texts are cached per render thread. The size is
+        the maximum number of glyphs, 0 disables the cache.
+     */
+    QSK_EXPORT void setGlyphCacheSize( int );
+    QSK_EXPORT int glyphCacheSize();
 }
 
 #endif
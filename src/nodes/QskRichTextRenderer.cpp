@@ -7,21 +7,114 @@
 #include "QskTextColors.h"
 #include "QskTextOptions.h"
 
+#include <qabstracttextdocumentlayout.h>
+#include <qcache.h>
+#include <qfontmetrics.h>
 #include <qglobalstatic.h>
+#include <qglyphrun.h>
+#include <qmath.h>
 #include <qmutex.h>
+#include <qsgnode.h>
+#include <qsgsimplerectnode.h>
+#include <qtextdocument.h>
+#include <qtextlayout.h>
+#include <qtextobject.h>
 #include <qthread.h>
-
-class QQuickWindow;
+#include <qthreadstorage.h>
 
 QSK_QT_PRIVATE_BEGIN
+#include <private/qsgadaptationlayer_p.h>
+#include <private/qsgcontext_p.h>
+#include <private/qquickitem_p.h>
 #include <private/qquicktext_p.h>
 #include <private/qquicktext_p_p.h>
 QSK_QT_PRIVATE_END
 
-// Since Qt 5.7 QQuickTextNode is public and could be used TODO ...
+// the same flag as being used in QskPlainTextRenderer
+#define GlyphFlag static_cast< QSGNode::Flag >( 0x800 )
+
+/*
+    Rich texts are laid out by a QTextDocument. The glyph runs
+    and decorations of the layout are cached, so that we don't need
+    to parse and layout the text again for the same parameters.
+
+    Like QQuickText, we don't support eliding for rich texts.
+
+    Inline images, lists, tables, horizontal rulers and backgrounds
+    are not extracted from the layout. Documents with those are
+    rendered by a hidden QQuickText instead.
+ */
 
 namespace
 {
+    class LayoutKey
+    {
+      public:
+        inline bool operator==( const LayoutKey& other ) const
+        {
+            return ( width == other.width ) && ( alignment == other.alignment )
+                && ( options == other.options ) && ( font == other.font )
+                && ( text == other.text );
+        }
+
+        QString text;
+        QFont font;
+        QskTextOptions options;
+        int alignment;
+        qreal width;
+    };
+
+    inline QskHashValue qHash( const LayoutKey& key, QskHashValue seed = 0 )
+    {
+        auto hash = ::qHash( key.text, seed );
+        hash = ::qHash( key.font, hash );
+        hash = key.options.hash( hash );
+        hash = ::qHash( key.alignment, hash );
+        hash = qHashBits( &key.width, sizeof( key.width ), hash );
+
+        return hash;
+    }
+
+    enum ColorRole
+    {
+        TextColor,
+        LinkColor,
+        FormatColor
+    };
+
+    class GlyphRun
+    {
+      public:
+        QPointF position;
+        QGlyphRun glyphRun;
+
+        ColorRole colorRole;
+        QColor color;
+    };
+
+    class Decoration
+    {
+      public:
+        QRectF rect;
+
+        ColorRole colorRole;
+        QColor color;
+    };
+
+    class TextLayout
+    {
+      public:
+        QVector< GlyphRun > glyphRuns;
+        QVector< Decoration > decorations;
+
+        QSizeF size;
+
+        // the document needs to be rendered by QQuickText
+        bool isComplex = false;
+    };
+
+    using TextLayoutCache = QCache< LayoutKey, TextLayout >;
+
     class TextItem final : public QQuickText
     {
       public:
@@ -181,6 +274,12 @@ namespace
     };
 }
 
+/*
+    Font engines are cached per thread, so we have one
+    cache for each thread - usually the GUI and a render thread.
+ */
+static QThreadStorage< TextLayoutCache* > qskTextLayoutCaches;
+
 /*
     size requests and rendering might be from different threads and we
     better use different items as we might end up in events internally
@@ -188,7 +287,315 @@ namespace
  */
 Q_GLOBAL_STATIC( TextItemMap, qskTextItemMap )
 
-QSizeF QskRichTextRenderer::textSize(
+static inline ColorRole qskColorRole( const QTextCharFormat& format )
+{
+    if ( format.isAnchor() )
+        return LinkColor;
+
+    if ( format.foreground().style() != Qt::NoBrush )
+        return FormatColor;
+
+    return TextColor;
+}
+
+static inline QColor qskColor( ColorRole role,
+    const QColor& formatColor, const QskTextColors& colors )
+{
+    switch ( role )
+    {
+        case LinkColor:
+            return colors.linkColor.isValid() ? colors.linkColor : colors.textColor;
+
+        case FormatColor:
+            return formatColor;
+
+        default:
+            return colors.textColor;
+    }
+}
+
+static void qskAddDecorations( TextLayout& textLayout,
+    const QTextLine& line, const QPointF& pos, int from, int to,
+    const QTextCharFormat& format, ColorRole colorRole )
+{
+    const bool underline = format.fontUnderline()
+        || ( format.underlineStyle() != QTextCharFormat::NoUnderline );
+
+    if ( !( underline || format.fontOverline() || format.fontStrikeOut() ) )
+        return;
+
+    const QFontMetricsF fm( format.font() );
+
+    const qreal x1 = pos.x() + line.cursorToX( from );
+    const qreal x2 = pos.x() + line.cursorToX( to );
+    const qreal baseLine = pos.y() + line.y() + line.ascent();
+    const qreal lineWidth = qMax( fm.lineWidth(), qreal( 1.0 ) );
+
+    Decoration decoration;
+    decoration.colorRole = colorRole;
+    decoration.color = format.foreground().color();
+
+    if ( underline )
+    {
+        decoration.rect = QRectF( x1, baseLine + fm.underlinePos(), x2 - x1, lineWidth );
+        textLayout.decorations += decoration;
+    }
+
+    if ( format.fontOverline() )
+    {
+        decoration.rect = QRectF( x1, baseLine - fm.overlinePos(), x2 - x1, lineWidth );
+        textLayout.decorations += decoration;
+    }
+
+    if ( format.fontStrikeOut() )
+    {
+        decoration.rect = QRectF( x1, baseLine - fm.strikeOutPos(), x2 - x1, lineWidth );
+        textLayout.decorations += decoration;
+    }
+}
+
+static bool qskIsComplexDocument( const QTextDocument& document )
+{
+    const auto rootFrame = document.rootFrame();
+
+    // tables are frames
+    if ( !rootFrame->childFrames().isEmpty() )
+        return true;
+
+    if ( rootFrame->frameFormat().background().style() != Qt::NoBrush )
+        return true;
+
+    for ( auto block = document.begin(); block.isValid(); block = block.next() )
+    {
+        if ( block.textList() )
+            return true;
+
+        const auto blockFormat = block.blockFormat();
+
+        if ( blockFormat.hasProperty( QTextFormat::BlockTrailingHorizontalRulerWidth )
+            || blockFormat.background().style() != Qt::NoBrush )
+        {
+            return true;
+        }
+
+        for ( auto it = block.begin(); !it.atEnd(); ++it )
+        {
+            const auto format = it.fragment().charFormat();
+
+            if ( format.isImageFormat() || format.background().style() != Qt::NoBrush )
+                return true;
+        }
+    }
+
+    return false;
+}
+
+static TextLayout qskCreateTextLayout( const QString& text, const QFont& font,
+    const QskTextOptions& options, Qt::Alignment alignment, qreal width )
+{
+    QTextDocument document;
+    document.setDocumentMargin( 0 );
+    document.setDefaultFont( font );
+
+    QTextOption textOption( alignment & Qt::AlignHorizontal_Mask );
+    textOption.setWrapMode( static_cast< QTextOption::WrapMode >( options.wrapMode() ) );
+    document.setDefaultTextOption( textOption );
+
+    TextLayout textLayout;
+
+    if ( options.effectiveFormat( text ) == QskTextOptions::PlainText )
+    {
+        document.setPlainText( text );
+    }
+    else
+    {
+        document.setHtml( text );
+
+        if ( qskIsComplexDocument( document ) )
+        {
+            textLayout.isComplex = true;
+            return textLayout;
+        }
+    }
+
+    document.setTextWidth( width );
+
+    const auto documentLayout = document.documentLayout();
+
+    qreal right = 0.0;
+    qreal bottom = 0.0;
+
+    int lineCount = 0;
+    const int maxLineCount = options.maximumLineCount();
+
+    for ( auto block = document.begin();
+        block.isValid() && lineCount < maxLineCount; block = block.next() )
+    {
+        const auto layout = block.layout();
+        if ( layout == nullptr )
+            continue;
+
+        const auto pos = documentLayout->blockBoundingRect( block ).topLeft();
+
+        for ( int i = 0; i < layout->lineCount() && lineCount < maxLineCount; i++ )
+        {
+            const auto line = layout->lineAt( i );
+            lineCount++;
+
+            right = qMax( right, pos.x() + line.x() + line.naturalTextWidth() );
+            bottom = qMax( bottom, pos.y() + line.y() + line.height() );
+
+            const int lineStart = line.textStart();
+            const int lineEnd = lineStart + line.textLength();
+
+            for ( auto it = block.begin(); !it.atEnd(); ++it )
+            {
+                const auto fragment = it.fragment();
+                if ( !fragment.isValid() )
+                    continue;
+
+                const int fragmentStart = fragment.position() - block.position();
+
+                const int from = qMax( fragmentStart, lineStart );
+                const int to = qMin( fragmentStart + fragment.length(), lineEnd );
+
+                if ( from >= to )
+                    continue;
+
+                const auto format = fragment.charFormat();
+                const auto colorRole = qskColorRole( format );
+
+                const auto glyphRuns = line.glyphRuns( from, to - from );
+                for ( const auto& glyphRun : glyphRuns )
+                {
+                    GlyphRun run;
+                    run.position = pos;
+                    run.glyphRun = glyphRun;
+                    run.colorRole = colorRole;
+                    run.color = format.foreground().color();
+
+                    textLayout.glyphRuns += run;
+                }
+
+                qskAddDecorations( textLayout, line, pos, from, to, format, colorRole );
+            }
+        }
+    }
+
+    textLayout.size = QSizeF( right, bottom );
+
+    return textLayout;
+}
+
+static TextLayout qskTextLayout( const QString& text, const QFont& font,
+    const QskTextOptions& options, Qt::Alignment alignment, qreal width )
+{
+    if ( !qskTextLayoutCaches.hasLocalData() )
+    {
+        auto cache = new TextLayoutCache();
+        cache->setMaxCost( 200 ); // number of layouts
+
+        qskTextLayoutCaches.setLocalData( cache );
+    }
+
+    auto cache = qskTextLayoutCaches.localData();
+
+    LayoutKey key;
+    key.text = text;
+    key.font = font;
+    key.options = options;
+    key.alignment = alignment & Qt::AlignHorizontal_Mask;
+    key.width = width;
+
+    if ( const auto textLayout = cache->object( key ) )
+        return *textLayout;
+
+    const auto textLayout = qskCreateTextLayout(
+        text, font, options, alignment, width );
+
+    cache->insert( key, new TextLayout( textLayout ) );
+
+    return textLayout;
+}
+
+static void qskRenderText( QQuickItem* item, QSGNode* parentNode,
+    const TextLayout& textLayout, qreal yOffset, QQuickText::TextStyle style,
+    const QskTextColors& colors )
+{
+    auto renderContext = QQuickItemPrivate::get( item )->sceneGraphRenderContext();
+    auto sgContext = renderContext->sceneGraphContext();
+
+    // Clear out foreign nodes ( e.g. the decorations of a previous update )
+    QSGNode* node = parentNode->firstChild();
+    while ( node )
+    {
+        auto sibling = node->nextSibling();
+        if ( !( node->flags() & GlyphFlag ) )
+        {
+            parentNode->removeChildNode( node );
+            delete node;
+        }
+        node = sibling;
+    }
+
+    auto glyphNode = static_cast< QSGGlyphNode* >( parentNode->firstChild() );
+
+    for ( const auto& run : textLayout.glyphRuns )
+    {
+        if ( glyphNode == nullptr )
+        {
+            const bool preferNativeGlyphNode = false; // QskTextOptions?
+
+#if QT_VERSION >= QT_VERSION_CHECK( 6, 0, 0 )
+            constexpr int renderQuality = -1; // QQuickText::DefaultRenderTypeQuality
+            glyphNode = sgContext->createGlyphNode(
+                renderContext, preferNativeGlyphNode, renderQuality );
+#else
+            glyphNode = sgContext->createGlyphNode(
+                renderContext, preferNativeGlyphNode );
+#endif
+            glyphNode->setOwnerElement( item );
+            glyphNode->setFlags( QSGNode::OwnedByParent | GlyphFlag );
+        }
+
+        // glyph nodes expect the position of the ascent
+        const QPointF position = run.position
+            + QPointF( 0.0, yOffset + run.glyphRun.rawFont().ascent() );
+
+        glyphNode->setStyle( style );
+        glyphNode->setColor( qskColor( run.colorRole, run.color, colors ) );
+        glyphNode->setStyleColor( colors.styleColor );
+        glyphNode->setGlyphs( position, run.glyphRun );
+        glyphNode->update();
+
+        if ( glyphNode->parent() != parentNode )
+            parentNode->appendChildNode( glyphNode );
+
+        glyphNode = static_cast< QSGGlyphNode* >( glyphNode->nextSibling() );
+    }
+
+    // Remove leftover glyphs
+    while ( glyphNode )
+    {
+        auto sibling = glyphNode->nextSibling();
+
+        parentNode->removeChildNode( glyphNode );
+        delete glyphNode;
+
+        glyphNode = static_cast< QSGGlyphNode* >( sibling );
+    }
+
+    for ( const auto& decoration : textLayout.decorations )
+    {
+        auto rectNode = new QSGSimpleRectNode(
+            decoration.rect.translated( 0.0, yOffset ),
+            qskColor( decoration.colorRole, decoration.color, colors ) );
+
+        parentNode->appendChildNode( rectNode );
+    }
+}
+
+static QSizeF qskComplexTextSize(
     const QString& text, const QFont& font, const QskTextOptions& options )
 {
     auto& textItem = *qskTextItemMap->item();
@@ -210,7 +617,7 @@ QSizeF QskRichTextRenderer::textSize(
     return sz;
 }
 
-QRectF QskRichTextRenderer::textRect(
+static QRectF qskComplexTextRect(
     const QString& text, const QFont& font,
     const QskTextOptions& options, const QSizeF& size )
 {
@@ -236,7 +643,7 @@ QRectF QskRichTextRenderer::textRect(
     return rect;
 }
 
-void QskRichTextRenderer::updateNode(
+static void qskUpdateComplexNode(
     const QString& text, const QFont& font,
     const QskTextOptions& options, Qsk::TextStyle style,
     const QskTextColors& colors, Qt::Alignment alignment,
@@ -291,3 +698,70 @@ void QskRichTextRenderer::updateNode(
     textItem.updateTextNode( item->window(), node );
     textItem.reset();
 }
+
+QSizeF QskRichTextRenderer::textSize(
+    const QString& text, const QFont& font, const QskTextOptions& options )
+{
+    const auto textLayout = qskTextLayout(
+        text, font, options, Qt::AlignLeft, -1.0 );
+
+    if ( textLayout.isComplex )
+        return qskComplexTextSize( text, font, options );
+
+    return textLayout.size;
+}
+
+QRectF QskRichTextRenderer::textRect(
+    const QString& text, const QFont& font,
+    const QskTextOptions& options, const QSizeF& size )
+{
+    const auto textLayout = qskTextLayout(
+        text, font, options, Qt::AlignLeft, size.width() );
+
+    if ( textLayout.isComplex )
+        return qskComplexTextRect( text, font, options, size );
+
+    return QRectF( QPointF(), textLayout.size );
+}
+
+void QskRichTextRenderer::updateNode(
+    const QString& text, const QFont& font,
+    const QskTextOptions& options, Qsk::TextStyle style,
+    const QskTextColors& colors, Qt::Alignment alignment,
+    const QRectF& rect, const QQuickItem* item, QSGTransformNode* node )
+{
+    const auto textLayout = qskTextLayout(
+        text, font, options, alignment, rect.width() );
+
+    if ( textLayout.isComplex )
+    {
+        qskUpdateComplexNode( text, font, options,
+            style, colors, alignment, rect, item, node );
+
+        return;
+    }
+
+    qreal yOffset = 0.0;
+
+    if ( alignment & Qt::AlignVCenter )
+    {
+        yOffset = 0.5 * ( rect.height() - textLayout.size.height() );
+    }
+    else if ( alignment & Qt::AlignBottom )
+    {
+        yOffset = rect.height() - textLayout.size.height();
+    }
+
+    if ( yOffset != 0.0 )
+    {
+        /*
+            We need to have a stable algo for rounding the text base line,
+            so that texts don't start wobbling, when processing transitions
+            between margins/paddings.
+         */
+        yOffset = qFloor( yOffset );
+    }
+
+    qskRenderText( const_cast< QQuickItem* >( item ), node, textLayout,
+        yOffset, static_cast< QQuickText::TextStyle >( style ), colors );
+}
@@ -4,6 +4,7 @@
  *****************************************************************************/
 
 #include "QskTextNode.h"
+#include "QskPlainTextRenderer.h"
 #include "QskTextColors.h"
 #include "QskTextOptions.h"
 #include "QskTextRenderer.h"
@@ -11,7 +12,35 @@
 #include <qfont.h>
 #include <qstring.h>
 
-static inline QskHashValue qskHash(
+/*
+    The attributes of a text are split into 3 groups:
+
+        - layout: attributes, that need reshaping the text
+        - paint: colors, that can be changed in the glyph nodes
+        - offset: the vertical alignment inside the rectangle
+
+    Rich texts are always rendered from scratch and all attributes
+    are part of the layout hash.
+ */
+
+static inline bool qskIsPlainText( const QskTextOptions& options )
+{
+    // the same condition as in QskTextRenderer::updateNode
+    return options.format() == QskTextOptions::PlainText;
+}
+
+static inline QskHashValue qskPaintHash(
+    const QskTextColors& colors, Qsk::TextStyle textStyle )
+{
+    QskHashValue hash = 12000;
+
+    hash = qHash( textStyle, hash );
+    hash = colors.hash( hash );
+
+    return hash;
+}
+
+static inline QskHashValue qskLayoutHash(
     const QString& text, const QSizeF& size, const QFont& font,
     const QskTextOptions& options, const QskTextColors& colors,
     Qt::Alignment alignment, Qsk::TextStyle textStyle )
@@ -21,16 +50,42 @@ static inline QskHashValue qskHash(
     hash = qHash( text, hash );
     hash = qHash( font, hash );
     hash = options.hash( hash );
-    hash = qHash( alignment, hash );
-    hash = qHash( textStyle, hash );
-    hash = colors.hash( hash );
+
+    if ( qskIsPlainText( options ) )
+    {
+        // horizontal alignments are applied to each line individually
+        hash = qHash( int( alignment & Qt::AlignHorizontal_Mask ), hash );
+
+        const auto width = size.width();
+        hash = qHashBits( &width, sizeof( width ), hash );
+    }
+    else
+    {
+        hash = qHash( alignment, hash );
+        hash = qHashBits( &size, sizeof( QSizeF ), hash );
+        hash = qHash( textStyle, hash );
+        hash = colors.hash( hash );
+    }
+
+    return hash;
+}
+
+static inline QskHashValue qskOffsetHash(
+    const QSizeF& size, Qt::Alignment alignment )
+{
+    QskHashValue hash = 13000;
+
+    hash = qHash( int( alignment & Qt::AlignVertical_Mask ), hash );
     hash = qHashBits( &size, sizeof( QSizeF ), hash );
 
     return hash;
 }
 
 QskTextNode::QskTextNode()
-    : m_hash( 0 )
+    : m_layoutHash( 0 )
+    , m_paintHash( 0 )
+    , m_offsetHash( 0 )
+    , m_offset( 0.0 )
 {
 }
 
@@ -43,27 +98,63 @@ void QskTextNode::setTextData(
     const QFont& font, const QskTextOptions& options, const QskTextColors& colors,
     Qt::Alignment alignment, Qsk::TextStyle textStyle )
 {
-    QMatrix4x4 matrix;
-    matrix.translate( rect.left(), rect.top() );
+    const bool isPlainText = qskIsPlainText( options );
 
-    if ( matrix != this->matrix() ) // avoid setting DirtyMatrix accidently
-        setMatrix( matrix );
+    const auto layoutHash = qskLayoutHash(
+        text, rect.size(), font, options, colors, alignment, textStyle );
+
+    const auto paintHash = qskPaintHash( colors, textStyle );
+
+    if ( layoutHash != m_layoutHash )
+    {
+        m_layoutHash = layoutHash;
+        m_paintHash = paintHash;
+        m_offsetHash = 0;
 
-    const auto hash = qskHash( text, rect.size(), font,
-        options, colors, alignment, textStyle );
+        if ( isPlainText )
+        {
+            /*
+                The text is rendered for the top and then
+                translated according to the vertical alignment
+             */
+            const auto flags = ( alignment & Qt::AlignHorizontal_Mask ) | Qt::AlignTop;
 
-    if ( hash != m_hash )
+            QskPlainTextRenderer::updateNode( text, font, options, textStyle,
+                colors, flags, QRectF( QPointF(), rect.size() ), item, this );
+        }
+        else
+        {
+            QskTextRenderer::updateNode( text, font, options, textStyle,
+                colors, alignment, QRectF( QPointF(), rect.size() ), item, this );
+        }
+    }
+    else if ( paintHash != m_paintHash )
     {
-        m_hash = hash;
+        m_paintHash = paintHash;
 
-        const QRectF textRect( 0, 0, rect.width(), rect.height() );
+        // colors can be changed without reshaping the text
+        QskPlainTextRenderer::updateNodeColor(
+            this, colors.textColor, textStyle, colors.styleColor );
+    }
 
-        /*
-            In case of having color changes only we would could
-            go a faster update path: see QskPlainTextRenderer::updateNodeColor.
-            TODO ...
-         */
-        QskTextRenderer::updateNode( text, font, options, textStyle,
-            colors, alignment, textRect, item, this );
+    if ( isPlainText )
+    {
+        const auto offsetHash = qskOffsetHash( rect.size(), alignment );
+        if ( offsetHash != m_offsetHash )
+        {
+            m_offsetHash = offsetHash;
+            m_offset = QskPlainTextRenderer::verticalOffset(
+                text, font, options, alignment, rect.size() );
+        }
+    }
+    else
+    {
+        m_offset = 0.0;
     }
+
+    QMatrix4x4 matrix;
+    matrix.translate( rect.left(), rect.top() + m_offset );
+
+    if ( matrix != this->matrix() ) // avoid setting DirtyMatrix accidently
+        setMatrix( matrix );
 }
@@ -29,7 +29,11 @@ class QSK_EXPORT QskTextNode : public QSGTransformNode
         Qt::Alignment, Qsk::TextStyle );
 
   private:
-    QskHashValue m_hash;
+    QskHashValue m_layoutHash;
+    QskHashValue m_paintHash;
+    QskHashValue m_offsetHash;
+
+    qreal m_offset;
 };
 
 #endif
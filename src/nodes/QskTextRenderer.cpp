@@ -8,8 +8,156 @@
 #include "QskRichTextRenderer.h"
 #include "QskTextOptions.h"
 
+#include <qatomic.h>
+#include <qcache.h>
+#include <qfont.h>
+#include <qguiapplication.h>
+#include <qmutex.h>
 #include <qrect.h>
 
+namespace
+{
+    class SizeKey
+    {
+      public:
+        inline bool operator==( const SizeKey& other ) const
+        {
+            return ( constrained == other.constrained ) && ( constraint == other.constraint )
+                && ( options == other.options )
+                && ( font == other.font ) && ( text == other.text );
+        }
+
+        QString text;
+        QFont font;
+        QskTextOptions options;
+        QSizeF constraint;
+        bool constrained;
+    };
+
+    inline QskHashValue qHash( const SizeKey& key, QskHashValue seed = 0 )
+    {
+        auto hash = ::qHash( key.text, seed );
+        hash = ::qHash( key.font, hash );
+        hash = key.options.hash( hash );
+        hash = qHashBits( &key.constraint, sizeof( key.constraint ), hash );
+        hash = ::qHash( key.constrained, hash );
+
+        return hash;
+    }
+
+    /*
+        Size hints are calculated over and over again with the same
+        texts, while the results only depend on the parameters - as long
+        as the available fonts do not change.
+
+        The cost of an entry is an estimate of its memory in bytes.
+     */
+    class SizeCache
+    {
+      public:
+        SizeCache()
+        {
+            cache.setMaxCost( 256 * 1024 );
+        }
+
+        void connectFontDatabase()
+        {
+            // called with the mutex being locked
+            if ( !isConnected && qGuiApp )
+            {
+                QObject::connect( qGuiApp, &QGuiApplication::fontDatabaseChanged,
+                    qGuiApp, [ this ]() { clear(); } );
+
+                isConnected = true;
+            }
+        }
+
+        void clear()
+        {
+            QMutexLocker locker( &mutex );
+            cache.clear();
+        }
+
+        QMutex mutex;
+        QCache< SizeKey, QSizeF > cache;
+
+        bool isConnected = false;
+
+        QAtomicInt hits;
+        QAtomicInt misses;
+    };
+}
+
+Q_GLOBAL_STATIC( SizeCache, qskSizeCache )
+
+static QSizeF qskTextSize( const QString& text, const QFont& font,
+    const QskTextOptions& options, const QSizeF* constraint )
+{
+    if ( options.effectiveFormat( text ) == QskTextOptions::PlainText )
+    {
+        if ( constraint )
+            return QskPlainTextRenderer::textRect( text, font, options, *constraint ).size();
+        else
+            return QskPlainTextRenderer::textSize( text, font, options );
+    }
+    else
+    {
+        if ( constraint )
+            return QskRichTextRenderer::textRect( text, font, options, *constraint ).size();
+        else
+            return QskRichTextRenderer::textSize( text, font, options );
+    }
+}
+
+static QSizeF qskCachedTextSize( const QString& text, const QFont& font,
+    const QskTextOptions& options, const QSizeF* constraint )
+{
+    auto sizeCache = qskSizeCache;
+    if ( sizeCache == nullptr ) // during application shutdown
+        return qskTextSize( text, font, options, constraint );
+
+    SizeKey key;
+    key.text = text;
+    key.font = font;
+    key.options = options;
+    key.constraint = constraint ? *constraint : QSizeF();
+    key.constrained = ( constraint != nullptr );
+
+    {
+        QMutexLocker locker( &sizeCache->mutex );
+
+        if ( sizeCache->cache.maxCost() > 0 )
+        {
+            if ( const auto size = sizeCache->cache.object( key ) )
+            {
+                sizeCache->hits.ref();
+                return *size;
+            }
+        }
+    }
+
+    sizeCache->misses.ref();
+
+    /*
+        Measuring is done without holding the lock. In the worst
+        case the same text is measured twice in parallel.
+     */
+    const auto size = qskTextSize( text, font, options, constraint );
+
+    const int cost = int( sizeof( SizeKey ) + sizeof( QSizeF ) )
+        + text.size() * int( sizeof( QChar ) );
+
+    QMutexLocker locker( &sizeCache->mutex );
+
+    if ( cost <= sizeCache->cache.maxCost() )
+    {
+        sizeCache->connectFontDatabase();
+        sizeCache->cache.insert( key, new QSizeF( size ), cost );
+    }
+
+    return size;
+}
+
 /*
     Since Qt 5.7 QQuickTextNode is exported as Q_QUICK_PRIVATE_EXPORT
     and could be used. TODO ...
@@ -17,20 +165,40 @@
 QSizeF QskTextRenderer::textSize(
     const QString& text, const QFont& font, const QskTextOptions& options )
 {
-    if ( options.effectiveFormat( text ) == QskTextOptions::PlainText )
-        return QskPlainTextRenderer::textSize( text, font, options );
-    else
-        return QskRichTextRenderer::textSize( text, font, options );
+    return qskCachedTextSize( text, font, options, nullptr );
 }
 
 QSizeF QskTextRenderer::textSize(
     const QString& text, const QFont& font, const QskTextOptions& options,
     const QSizeF& size )
 {
-    if ( options.effectiveFormat( text ) == QskTextOptions::PlainText )
-        return QskPlainTextRenderer::textRect( text, font, options, size ).size();
-    else
-        return QskRichTextRenderer::textRect( text, font, options, size ).size();
+    return qskCachedTextSize( text, font, options, &size );
+}
+
+void QskTextRenderer::setSizeCacheSize( int size )
+{
+    if ( auto sizeCache = qskSizeCache )
+    {
+        QMutexLocker locker( &sizeCache->mutex );
+        sizeCache->cache.setMaxCost( qMax( size, 0 ) );
+    }
+}
+
+int QskTextRenderer::sizeCacheSize()
+{
+    if ( auto sizeCache = qskSizeCache )
+    {
+        QMutexLocker locker( &sizeCache->mutex );
+        return sizeCache->cache.maxCost();
+    }
+
+    return 0;
+}
+
+void QskTextRenderer::clearSizeCache()
+{
+    if ( auto sizeCache = qskSizeCache )
+        sizeCache->clear();
 }
 
 void QskTextRenderer::updateNode(
@@ -49,3 +217,34 @@ void QskTextRenderer::updateNode(
             text, font, options, style, colors, alignment, rect, item, node );
     }
 }
+
+#ifndef QT_NO_DEBUG_STREAM
+
+#include <qdebug.h>
+
+void QskTextRenderer::debugStatistics( QDebug debug )
+{
+    auto sizeCache = qskSizeCache;
+    if ( sizeCache == nullptr )
+        return;
+
+    int count, cost;
+
+    {
+        QMutexLocker locker( &sizeCache->mutex );
+
+        count = sizeCache->cache.count();
+        cost = sizeCache->cache.totalCost();
+    }
+
+    QDebugStateSaver saver( debug );
+    debug.nospace();
+    debug << "TextSizes(";
+    debug << "hits: " << sizeCache->hits.loadRelaxed()
+          << ", misses: " << sizeCache->misses.loadRelaxed()
+          << ", entries: " << count
+          << ", bytes: " << cost;
+    debug << ')';
+}
+
+#endif
@@ -18,6 +18,7 @@ class QRectF;
 class QSizeF;
 class QQuickItem;
 class QSGTransformNode;
+class QDebug;
 
 namespace QskTextRenderer
 {
@@ -31,6 +32,20 @@ namespace QskTextRenderer
 
     QSK_EXPORT QSizeF textSize(
         const QString&, const QFont&, const QskTextOptions&, const QSizeF& );
+
+    /*
+        Results of textSize are cached. The size of the cache is
+        an estimated memory budget in bytes, 0 disables the cache.
+        The cache is cleared, when the font database changes.
+     */
+    QSK_EXPORT void setSizeCacheSize( int );
+    QSK_EXPORT int sizeCacheSize();
+    QSK_EXPORT void clearSizeCache();
+
+#ifndef QT_NO_DEBUG_STREAM
+    // hits/misses of the size cache
+    QSK_EXPORT void debugStatistics( QDebug );
+#endif
 }
 
 #endif
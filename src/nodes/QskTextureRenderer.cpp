@@ -7,10 +7,15 @@
 
 #include <qopenglcontext.h>
 #include <qopenglframebufferobject.h>
+#include <qopenglfunctions.h>
 #include <qopenglpaintdevice.h>
 
 #include <qimage.h>
 #include <qpainter.h>
+#include <qvector.h>
+#include <qhash.h>
+#include <qmutex.h>
+#include <qdebug.h>
 
 #include <qquickwindow.h>
 
@@ -29,7 +34,7 @@ static GLuint qskTakeTexture( QOpenGLFramebufferObject& fbo )
     /*
         See https://bugreports.qt.io/browse/QTBUG-103929
 
-        As we create a FBO for each update of a node we can't live
+        As we create a FBO for each painted texture we can't live
         without having this ( ugly ) workaround.
      */
     class MyFBO
@@ -63,6 +68,327 @@ static GLuint qskTakeTexture( QOpenGLFramebufferObject& fbo )
     return textureId;
 }
 
+namespace
+{
+    class FboStatistics
+    {
+      public:
+        QAtomicInt allocated;
+        QAtomicInt reused;
+        QAtomicInt deleted;
+    };
+
+    FboStatistics qskFboStatistics;
+
+    /*
+        Size animations result in painting textures of a different size
+        in every frame. To avoid allocating FBOs all the time we reuse them
+        for sizes, that fall into the same bucket.
+
+        FBOs are deleted only, when the context of the pool is current.
+        For FBOs, that are released without a current context, the pool
+        is found by a registry of all FBOs, that have been handed out.
+     */
+    class FboPool : public QObject
+    {
+      public:
+        static FboPool* instance( QOpenGLContext* context )
+        {
+            auto object = context->findChild< QObject* >(
+                poolName(), Qt::FindDirectChildrenOnly );
+
+            if ( object == nullptr )
+                return new FboPool( context );
+
+            return static_cast< FboPool* >( object );
+        }
+
+        static FboPool* owner( const QOpenGLFramebufferObject* fbo )
+        {
+            QMutexLocker locker( &registryMutex );
+            return registry.value( fbo, nullptr );
+        }
+
+        ~FboPool() override
+        {
+            // usually done by aboutToBeDestroyed already
+            deleteAll();
+        }
+
+        QOpenGLFramebufferObject* take( const QSize& size,
+            const QOpenGLFramebufferObjectFormat& format )
+        {
+            QOpenGLFramebufferObject* fbo = nullptr;
+
+            for ( int i = m_fbos.size() - 1; i >= 0; i-- )
+            {
+                if ( m_fbos[ i ]->size() == size && m_fbos[ i ]->format() == format )
+                {
+                    fbo = m_fbos.takeAt( i );
+                    qskFboStatistics.reused.ref();
+
+                    break;
+                }
+            }
+
+            if ( fbo == nullptr )
+            {
+                fbo = new QOpenGLFramebufferObject( size, format );
+                qskFboStatistics.allocated.ref();
+            }
+
+            QMutexLocker locker( &registryMutex );
+            registry.insert( fbo, this );
+
+            return fbo;
+        }
+
+        void give( QOpenGLFramebufferObject* fbo )
+        {
+            {
+                QMutexLocker locker( &registryMutex );
+                registry.remove( fbo );
+            }
+
+            m_fbos += fbo;
+
+            if ( isCurrent() )
+            {
+                while ( m_fbos.size() > maxFbos )
+                    deleteFbo( m_fbos.takeFirst() );
+            }
+        }
+
+        static void deleteFbo( QOpenGLFramebufferObject* fbo )
+        {
+            qskFboStatistics.deleted.ref();
+            delete fbo;
+        }
+
+      private:
+        FboPool( QOpenGLContext* context )
+            : QObject( context )
+        {
+            setObjectName( poolName() );
+
+            // the pool gets destroyed together with the context
+
+            connect( context, &QOpenGLContext::aboutToBeDestroyed,
+                this, &FboPool::cleanup, Qt::DirectConnection );
+        }
+
+        inline QOpenGLContext* context() const
+        {
+            return static_cast< QOpenGLContext* >( parent() );
+        }
+
+        inline bool isCurrent() const
+        {
+            return QOpenGLContext::currentContext() == context();
+        }
+
+        void cleanup()
+        {
+            auto current = QOpenGLContext::currentContext();
+            auto surface = current ? current->surface() : nullptr;
+
+            auto context = this->context();
+
+            if ( current != context && context->surface() )
+                context->makeCurrent( context->surface() );
+
+            deleteAll();
+
+            if ( current != context )
+            {
+                if ( current )
+                    current->makeCurrent( surface );
+                else
+                    context->doneCurrent();
+            }
+        }
+
+        void deleteAll()
+        {
+            /*
+                The FBOs, that are still in use, lose their resources
+                together with the context. They are deleted without
+                a current context, when being released.
+             */
+            {
+                QMutexLocker locker( &registryMutex );
+
+                for ( auto it = registry.begin(); it != registry.end(); )
+                {
+                    if ( it.value() == this )
+                        it = registry.erase( it );
+                    else
+                        ++it;
+                }
+            }
+
+            for ( auto fbo : qAsConst( m_fbos ) )
+                deleteFbo( fbo );
+
+            m_fbos.clear();
+        }
+
+        static inline QString poolName()
+        {
+            return QStringLiteral( "QskFboPool" );
+        }
+
+        enum { maxFbos = 8 };
+
+        // the most recently used FBOs are at the end
+        QVector< QOpenGLFramebufferObject* > m_fbos;
+
+        // FBOs, that have been handed out -> pool
+        static QMutex registryMutex;
+        static QHash< const QOpenGLFramebufferObject*, FboPool* > registry;
+    };
+
+    QMutex FboPool::registryMutex;
+    QHash< const QOpenGLFramebufferObject*, FboPool* > FboPool::registry;
+
+    class RasterStatistics
+    {
+      public:
+        QAtomicInt imagesAllocated;
+        QAtomicInt imagesReused;
+        QAtomicInt imagesDeleted;
+
+        QAtomicInt texturesCreated;
+        QAtomicInt texturesUpdated;
+    };
+
+    RasterStatistics qskRasterStatistics;
+
+    /*
+        The raster counterpart of the FBO pool. Images are shared
+        with the textures, until those have uploaded them. So an image
+        is only handed out again, when the pool holds the last reference
+        - otherwise painting into it would detach it.
+     */
+    class ImagePool
+    {
+      public:
+        QImage take( const QSize& size )
+        {
+            {
+                QMutexLocker locker( &m_mutex );
+
+                for ( int i = m_images.size() - 1; i >= 0; i-- )
+                {
+                    const auto& image = m_images[ i ];
+
+                    if ( image.size() == size && image.isDetached() )
+                    {
+                        qskRasterStatistics.imagesReused.ref();
+                        return m_images.takeAt( i );
+                    }
+                }
+            }
+
+            qskRasterStatistics.imagesAllocated.ref();
+            return QImage( size, QImage::Format_RGBA8888_Premultiplied );
+        }
+
+        void give( const QImage& image )
+        {
+            QMutexLocker locker( &m_mutex );
+
+            m_images += image;
+
+            while ( m_images.size() > maxImages )
+            {
+                m_images.removeFirst();
+                qskRasterStatistics.imagesDeleted.ref();
+            }
+        }
+
+      private:
+        enum { maxImages = 8 };
+
+        QMutex m_mutex;
+
+        // the most recently used images are at the end
+        QVector< QImage > m_images;
+    };
+}
+
+Q_GLOBAL_STATIC( ImagePool, qskImagePool )
+
+static inline QSize qskBucketSize( const QSize& size )
+{
+    // rounding up to multiples of 64 pixels
+    return QSize( ( size.width() + 63 ) & ~63, ( size.height() + 63 ) & ~63 );
+}
+
+static void qskPaintFbo( QQuickWindow* window, const QSize& size,
+    QskTextureRenderer::PaintHelper* helper, QOpenGLFramebufferObject* fbo )
+{
+    auto context = QOpenGLContext::currentContext();
+    auto pool = FboPool::instance( context );
+
+    QOpenGLFramebufferObjectFormat format;
+    format.setAttachment( QOpenGLFramebufferObject::CombinedDepthStencil );
+
+    format.setSamples( context->format().samples() );
+
+    /*
+        The multisampled FBO is only needed while painting,
+        so all textures can share the FBOs of the pool.
+     */
+    auto multisampledFbo = pool->take( qskBucketSize( size ), format );
+    multisampledFbo->bind();
+
+    {
+        /*
+            Pooled FBOs are larger than the painted area. Clearing
+            them completely, so that linear filtering at the borders
+            of the painted area does not pick up outdated content.
+         */
+        auto gl = context->functions();
+
+        gl->glClearColor( 0.0f, 0.0f, 0.0f, 0.0f );
+        gl->glClear( GL_COLOR_BUFFER_BIT );
+    }
+
+    QOpenGLPaintDevice pd( size );
+    pd.setPaintFlipped( true );
+
+    {
+        QPainter painter( &pd );
+
+        const auto ratio = window->effectiveDevicePixelRatio();
+
+        painter.scale( ratio, ratio );
+        helper->paint( &painter, size / ratio );
+
+#if 1
+        if ( format.samples() > 0 )
+        {
+            /*
+                Multisampling in the window surface might get lost
+                as a side effect of rendering to the FBO.
+                weired, needs to be investigated more
+             */
+            painter.setRenderHint( QPainter::Antialiasing, true );
+        }
+#endif
+    }
+
+    // the multisampled FBO is at least as large as the target FBO
+    const QRect rect( QPoint( 0, 0 ), fbo->size() );
+
+    QOpenGLFramebufferObject::blitFramebuffer(
+        fbo, rect, multisampledFbo, rect );
+
+    multisampledFbo->release();
+    pool->give( multisampledFbo );
+}
+
 bool QskTextureRenderer::isOpenGLWindow( const QQuickWindow* window )
 {
     if ( window == nullptr )
@@ -115,6 +441,23 @@ void QskTextureRenderer::setTextureId( QQuickWindow* window,
 #endif
 }
 
+void QskTextureRenderer::setFboTexture( QQuickWindow* window,
+    const QOpenGLFramebufferObject* fbo, QSGTexture* texture )
+{
+    auto plainTexture = qobject_cast< QSGPlainTexture* >( texture );
+    if ( plainTexture == nullptr )
+        return;
+
+    /*
+        With the RHI the texture owns a wrapper for the native texture only,
+        otherwise it would delete the texture of the FBO.
+     */
+    const auto rhi = QQuickWindowPrivate::get( window )->rhi;
+    plainTexture->setOwnsTexture( rhi != nullptr );
+
+    setTextureId( window, fbo->texture(), fbo->size(), plainTexture );
+}
+
 quint32 QskTextureRenderer::createPaintedTextureGL(
     QQuickWindow* window, const QSize& size, QskTextureRenderer::PaintHelper* helper )
 {
@@ -141,64 +484,74 @@ quint32 QskTextureRenderer::createPaintedTextureGL(
     window->resetOpenGLState();
 #endif
 
-    auto context = QOpenGLContext::currentContext();
+    QOpenGLFramebufferObjectFormat format;
+    format.setAttachment( QOpenGLFramebufferObject::NoAttachment );
 
-    QOpenGLFramebufferObjectFormat format1;
-    format1.setAttachment( QOpenGLFramebufferObject::CombinedDepthStencil );
+    QOpenGLFramebufferObject fbo( size, format );
+    qskPaintFbo( window, size, helper, &fbo );
 
-    format1.setSamples( context->format().samples() );
-
-    QOpenGLFramebufferObject multisampledFbo( size, format1 );
+    window->endExternalCommands();
 
-    QOpenGLPaintDevice pd( size );
-    pd.setPaintFlipped( true );
+    return qskTakeTexture( fbo );
+}
 
-    {
-        QPainter painter( &pd );
+QOpenGLFramebufferObject* QskTextureRenderer::paintPooledFboGL(
+    QQuickWindow* window, const QSize& size,
+    QskTextureRenderer::PaintHelper* helper, QOpenGLFramebufferObject* fbo )
+{
+    window->beginExternalCommands();
 
-        painter.setCompositionMode( QPainter::CompositionMode_Source );
-        painter.fillRect( 0, 0, size.width(), size.height(), Qt::transparent );
-        painter.setCompositionMode( QPainter::CompositionMode_SourceOver );
+#if QT_VERSION >= QT_VERSION_CHECK( 6, 0, 0 )
+    QQuickOpenGLUtils::resetOpenGLState();
+#else
+    window->resetOpenGLState();
+#endif
 
-        const auto ratio = window->effectiveDevicePixelRatio();
+    auto pool = FboPool::instance( QOpenGLContext::currentContext() );
 
-        painter.scale( ratio, ratio );
-        helper->paint( &painter, size / ratio );
+    const auto bucketSize = qskBucketSize( size );
 
-#if 1
-        if ( format1.samples() > 0 )
-        {
-            /*
-                Multisampling in the window surface might get lost
-                as a side effect of rendering to the FBO.
-                weired, needs to be investigated more
-             */
-            painter.setRenderHint( QPainter::Antialiasing, true );
-        }
-#endif
+    if ( fbo && fbo->size() != bucketSize )
+    {
+        releasePooledFboGL( fbo );
+        fbo = nullptr;
     }
 
-    QOpenGLFramebufferObjectFormat format2;
-    format2.setAttachment( QOpenGLFramebufferObject::NoAttachment );
+    if ( fbo == nullptr )
+    {
+        QOpenGLFramebufferObjectFormat format;
+        format.setAttachment( QOpenGLFramebufferObject::NoAttachment );
 
-    QOpenGLFramebufferObject fbo( size, format2 );
+        fbo = pool->take( bucketSize, format );
+    }
 
-    const QRect fboRect( 0, 0, size.width(), size.height() );
-
-    QOpenGLFramebufferObject::blitFramebuffer(
-        &fbo, fboRect, &multisampledFbo, fboRect );
+    qskPaintFbo( window, size, helper, fbo );
 
     window->endExternalCommands();
 
-    return qskTakeTexture( fbo );
+    return fbo;
 }
 
-static QSGTexture* qskCreateTextureRaster( QQuickWindow* window,
-    const QSize& size, QskTextureRenderer::PaintHelper* helper )
+void QskTextureRenderer::releasePooledFboGL( QOpenGLFramebufferObject* fbo )
 {
-    const auto ratio = window ? window->effectiveDevicePixelRatio() : 1.0;
+    if ( fbo == nullptr )
+        return;
 
-    QImage image( size * ratio, QImage::Format_RGBA8888_Premultiplied );
+    if ( auto pool = FboPool::owner( fbo ) )
+    {
+        pool->give( fbo );
+    }
+    else
+    {
+        // the context is gone and with it all resources of the FBO
+        FboPool::deleteFbo( fbo );
+    }
+}
+
+QImage QskTextureRenderer::paintPooledImage( QQuickWindow* window,
+    const QSize& size, PaintHelper* helper, bool exactSize )
+{
+    auto image = qskImagePool->take( exactSize ? size : qskBucketSize( size ) );
     image.fill( Qt::transparent );
 
     {
@@ -208,12 +561,66 @@ static QSGTexture* qskCreateTextureRaster( QQuickWindow* window,
             setting a devicePixelRatio for the image only works for
             value >= 1.0. So we have to scale manually.
          */
+        const auto ratio = window ? window->effectiveDevicePixelRatio() : 1.0;
         painter.scale( ratio, ratio );
 
-        helper->paint( &painter, size );
+        helper->paint( &painter, size / ratio );
     }
 
-    return window->createTextureFromImage( image, QQuickWindow::TextureHasAlphaChannel );
+    return image;
+}
+
+void QskTextureRenderer::releasePooledImage( const QImage& image )
+{
+    if ( image.isNull() || qskImagePool.isDestroyed() )
+        return;
+
+    qskImagePool->give( image );
+}
+
+QSGTexture* QskTextureRenderer::setTextureImage( QQuickWindow* window,
+    const QImage& image, bool mipmapped, QSGTexture* texture )
+{
+    if ( !mipmapped )
+    {
+        /*
+            A texture, that has been created with mipmaps, could be updated
+            as well, but not the other way round. As mipmapped images are
+            rounded to powers of 2 their sizes change rarely anyway.
+         */
+        auto plainTexture = qobject_cast< QSGPlainTexture* >( texture );
+
+        if ( plainTexture && plainTexture->textureSize() == image.size() )
+        {
+            // the native texture is updated in place
+            plainTexture->setImage( image );
+            qskRasterStatistics.texturesUpdated.ref();
+
+            return plainTexture;
+        }
+    }
+
+    QQuickWindow::CreateTextureOptions options = QQuickWindow::TextureHasAlphaChannel;
+    if ( mipmapped )
+        options |= QQuickWindow::TextureHasMipmaps;
+
+    qskRasterStatistics.texturesCreated.ref();
+    return window->createTextureFromImage( image, options );
+}
+
+static QSGTexture* qskCreateTextureRaster( QQuickWindow* window,
+    const QSize& size, QskTextureRenderer::PaintHelper* helper )
+{
+    using namespace QskTextureRenderer;
+
+    const auto ratio = window ? window->effectiveDevicePixelRatio() : 1.0;
+
+    const auto image = paintPooledImage( window, size * ratio, helper, true );
+    auto texture = setTextureImage( window, image, false, nullptr );
+
+    releasePooledImage( image );
+
+    return texture;
 }
 
 QSGTexture* QskTextureRenderer::createPaintedTexture(
@@ -236,3 +643,37 @@ QSGTexture* QskTextureRenderer::createPaintedTexture(
         return qskCreateTextureRaster( window, size, helper );
     }
 }
+
+#ifndef QT_NO_DEBUG_STREAM
+
+void QskTextureRenderer::debugStatistics( QDebug debug )
+{
+    const auto allocated = qskFboStatistics.allocated.loadRelaxed();
+    const auto deleted = qskFboStatistics.deleted.loadRelaxed();
+
+    const auto imagesAllocated = qskRasterStatistics.imagesAllocated.loadRelaxed();
+    const auto imagesDeleted = qskRasterStatistics.imagesDeleted.loadRelaxed();
+
+    QDebugStateSaver saver( debug );
+    debug.nospace();
+    debug << "FBOs(";
+    debug << "allocated: " << allocated
+          << ", reused: " << qskFboStatistics.reused.loadRelaxed()
+          << ", deleted: " << deleted
+          << ", current: " << allocated - deleted;
+    debug << ')';
+
+    debug << " Images(";
+    debug << "allocated: " << imagesAllocated
+          << ", reused: " << qskRasterStatistics.imagesReused.loadRelaxed()
+          << ", deleted: " << imagesDeleted
+          << ", current: " << imagesAllocated - imagesDeleted;
+    debug << ')';
+
+    debug << " Textures(";
+    debug << "created: " << qskRasterStatistics.texturesCreated.loadRelaxed()
+          << ", updated: " << qskRasterStatistics.texturesUpdated.loadRelaxed();
+    debug << ')';
+}
+
+#endif
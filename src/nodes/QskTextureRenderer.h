@@ -9,9 +9,12 @@
 #include "QskGlobal.h"
 
 class QSize;
+class QImage;
 class QPainter;
 class QSGTexture;
 class QQuickWindow;
+class QOpenGLFramebufferObject;
+class QDebug;
 
 namespace QskTextureRenderer
 {
@@ -35,8 +38,47 @@ namespace QskTextureRenderer
     quint32 createPaintedTextureGL(
         QQuickWindow*, const QSize&, QskTextureRenderer::PaintHelper* );
 
+    /*
+        Painting into a FBO from a pool of FBOs, that are bucketed by
+        rounded up sizes. The FBO of the previous update is reused, when
+        being from the same bucket - otherwise it is returned to the pool.
+        The painted pixels are in the area [ 0, 0, size ] of the texture.
+     */
+    QOpenGLFramebufferObject* paintPooledFboGL( QQuickWindow*, const QSize&,
+        QskTextureRenderer::PaintHelper*, QOpenGLFramebufferObject* );
+
+    void releasePooledFboGL( QOpenGLFramebufferObject* );
+
+    // assigning the texture of a FBO, that remains owned by the FBO
+    void setFboTexture( QQuickWindow*,
+        const QOpenGLFramebufferObject*, QSGTexture* );
+
+    /*
+        Painting into an image from a pool of images for the raster path.
+        Images are bucketed like the FBOs - unless exactSize is set - and
+        the painted pixels are in the area [ 0, 0, size ] of the image.
+        Released images are handed out again, when no texture holds
+        a reference anymore.
+     */
+    QImage paintPooledImage( QQuickWindow*, const QSize&,
+        QskTextureRenderer::PaintHelper*, bool exactSize = false );
+
+    void releasePooledImage( const QImage& );
+
+    /*
+        Updating a texture without mipmaps in place, when it has the
+        size of the image. Otherwise a new texture is returned.
+     */
+    QSGTexture* setTextureImage( QQuickWindow*,
+        const QImage&, bool mipmapped, QSGTexture* );
+
     QSK_EXPORT QSGTexture* createPaintedTexture(
         QQuickWindow* window, const QSize& size, PaintHelper* helper );
+
+#ifndef QT_NO_DEBUG_STREAM
+    // allocations and reuses of FBOs, images and textures
+    QSK_EXPORT void debugStatistics( QDebug );
+#endif
 }
 
 #endif
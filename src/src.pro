@@ -77,8 +77,11 @@ SOURCES += \
 HEADERS += \
     graphic/QskColorFilter.h \
     graphic/QskGraphic.h \
+    graphic/QskGraphicArchive.h \
+    graphic/QskGraphicArchiveProvider.h \
     graphic/QskGraphicImageProvider.h \
     graphic/QskGraphicIO.h \
+    graphic/QskGraphicOptimizer.h \
     graphic/QskGraphicPaintEngine.h \
     graphic/QskGraphicProvider.h \
     graphic/QskGraphicProviderMap.h \
@@ -89,8 +92,11 @@ HEADERS += \
 SOURCES += \
     graphic/QskColorFilter.cpp \
     graphic/QskGraphic.cpp \
+    graphic/QskGraphicArchive.cpp \
+    graphic/QskGraphicArchiveProvider.cpp \
     graphic/QskGraphicImageProvider.cpp \
     graphic/QskGraphicIO.cpp \
+    graphic/QskGraphicOptimizer.cpp \
     graphic/QskGraphicPaintEngine.cpp \
     graphic/QskGraphicProvider.cpp \
     graphic/QskGraphicProviderMap.cpp \
@@ -322,6 +328,7 @@ SOURCES += \
     controls/QskWindow.cpp
 
 HEADERS += \
+    layouts/QskAnchorLayoutEngine.h \
     layouts/QskGridBox.h \
     layouts/QskGridLayoutEngine.h \
     layouts/QskIndexedLayoutBox.h \
@@ -333,9 +340,11 @@ HEADERS += \
     layouts/QskLinearLayoutEngine.h \
     layouts/QskStackBoxAnimator.h \
     layouts/QskStackBox.h \
-    layouts/QskSubcontrolLayoutEngine.h
+    layouts/QskSubcontrolLayoutEngine.h \
+    layouts/QskVirtualGridBox.h
 
 SOURCES += \
+    layouts/QskAnchorLayoutEngine.cpp \
     layouts/QskGridBox.cpp \
     layouts/QskGridLayoutEngine.cpp \
     layouts/QskIndexedLayoutBox.cpp \
@@ -347,7 +356,15 @@ SOURCES += \
     layouts/QskLinearLayoutEngine.cpp \
     layouts/QskStackBoxAnimator.cpp \
     layouts/QskStackBox.cpp \
-    layouts/QskSubcontrolLayoutEngine.cpp
+    layouts/QskSubcontrolLayoutEngine.cpp \
+    layouts/QskVirtualGridBox.cpp
+
+# Cassowary constraint solver ( https://github.com/nucleic/kiwi ),
+# the headers are internal and not installed
+SOURCES += \
+    layouts/kiwi/Constraint.cpp \
+    layouts/kiwi/Expression.cpp \
+    layouts/kiwi/Solver.cpp
 
 HEADERS += \
     dialogs/QskDialog.h \
@@ -9,6 +9,12 @@
 #include <QPen>
 #include <QPainter>
 
+SkinnyShapeProvider::~SkinnyShapeProvider()
+{
+    // prefetch tasks must not call loadGraphic of a destroyed object
+    cancelPrefetch();
+}
+
 const QskGraphic* SkinnyShapeProvider::loadGraphic( const QString& id ) const
 {
     QString shapeName, colorName;
@@ -10,6 +10,9 @@
 
 class SKINNY_EXPORT SkinnyShapeProvider : public QskGraphicProvider
 {
+  public:
+    ~SkinnyShapeProvider() override;
+
   protected:
     const QskGraphic* loadGraphic( const QString& id ) const override final;
 };
@@ -6,6 +6,8 @@
 #include <QskWindow.h>
 #include <QskControl.h>
 #include <QskQuick.h>
+#include <QskTextRenderer.h>
+#include <QskTextureRenderer.h>
 
 #include <QQuickItem>
 #include <QKeySequence>
@@ -191,6 +193,9 @@ void SkinnyShortcut::debugStatistics()
         qDebug() << w << "\n\titems:" << counter[0] << "visible" << counter[1]
                  << "\n\tnodes:" << counter[2] << "visible" << counter[3];
     }
+
+    QskTextureRenderer::debugStatistics( qDebug() );
+    QskTextRenderer::debugStatistics( qDebug() );
 }
 
 #include "moc_SkinnyShortcut.cpp"
@@ -10,24 +10,273 @@
 #include <QskPainterCommand.cpp>
 #include <QskGraphicPaintEngine.cpp>
 #include <QskGraphicIO.cpp>
+#include <QskGraphicArchive.cpp>
+#include <QskGraphicOptimizer.cpp>
 #else
+#include <QskGraphicArchive.h>
 #include <QskGraphicIO.h>
+#include <QskGraphicOptimizer.h>
 #include <QskGraphic.h>
 #endif
 
 #include <QGuiApplication>
 #include <QSvgRenderer>
 #include <QPainter>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QImage>
 #include <QDebug>
 
 static void usage( const char* appName )
 {
-    qWarning() << "usage: " << appName << "svgfile qvgfile";
+    qWarning() << "usage: " << appName << "[-O0] [-v] svgfile qvgfile";
+    qWarning() << "       " << appName << "[-O0] [-v] [-j jobs] -a archive ( svgdir | manifest )";
+    qWarning() << "        -v: command reduction, render times for single files only";
+}
+
+static bool loadSvg( const QString& fileName, QskGraphic& graphic )
+{
+    QSvgRenderer renderer;
+    if ( !renderer.load( fileName ) )
+        return false;
+
+    QPainter painter( &graphic );
+    renderer.render( &painter );
+    painter.end();
+
+    if ( graphic.commandTypes() & QskGraphic::RasterData )
+        qWarning() << fileName << "contains non scalable parts.";
+
+    return true;
+}
+
+static QskGraphic optimizedGraphic( const QskGraphic& graphic, int& numCommands )
+{
+    const auto optimized = QskGraphicOptimizer::optimized( graphic );
+    numCommands = optimized.commands().size();
+
+    return optimized;
+}
+
+static void printStatistics( const QString& name, int numCommands, int numOptimized )
+{
+    const double ratio = ( numCommands > 0 )
+        ? 100.0 * ( numCommands - numOptimized ) / numCommands : 0.0;
+
+    qDebug().noquote() << name << ":" << numCommands << "->" << numOptimized
+        << QStringLiteral( "commands ( -%1% )" ).arg( ratio, 0, 'f', 1 );
+}
+
+static double renderTime( const QskGraphic& graphic )
+{
+    /*
+        The average time for rendering the graphic into a raster
+        image in ms. The first run is not taken into account, as it
+        realizes the lazy parts of the graphic.
+     */
+    const int iterations = 20;
+
+    QImage image( 256, 256, QImage::Format_ARGB32_Premultiplied );
+
+    QElapsedTimer timer;
+
+    for ( int i = 0; i <= iterations; i++ )
+    {
+        if ( i == 1 )
+            timer.start();
+
+        image.fill( Qt::transparent );
+
+        QPainter painter( &image );
+        graphic.render( &painter, QRectF( 0, 0, 256, 256 ), Qt::KeepAspectRatio );
+    }
+
+    return timer.nsecsElapsed() / 1e6 / iterations;
+}
+
+static void printRenderTimes( const QString& name,
+    const QskGraphic& graphic, const QskGraphic& optimized )
+{
+    const auto t1 = renderTime( graphic );
+    const auto t2 = renderTime( optimized );
+
+    qDebug().noquote() << name << ":"
+        << QStringLiteral( "%1ms -> %2ms render time" )
+            .arg( t1, 0, 'f', 3 ).arg( t2, 0, 'f', 3 );
+}
+
+static inline QString graphicId( const QString& path )
+{
+    auto id = QDir::fromNativeSeparators( path );
+    if ( id.endsWith( QStringLiteral( ".svg" ), Qt::CaseInsensitive ) )
+        id.chop( 4 );
+
+    return id;
+}
+
+static QMap< QString, QString > svgSources( const QString& path )
+{
+    // id -> svg file
+
+    QMap< QString, QString > sources;
+
+    const QFileInfo fileInfo( path );
+
+    if ( fileInfo.isDir() )
+    {
+        const QDir dir( path );
+
+        QDirIterator it( path, QStringList( QStringLiteral( "*.svg" ) ),
+            QDir::Files, QDirIterator::Subdirectories );
+
+        while ( it.hasNext() )
+        {
+            const auto fileName = it.next();
+            sources.insert( graphicId( dir.relativeFilePath( fileName ) ), fileName );
+        }
+    }
+    else
+    {
+        /*
+            A manifest has one SVG file per line - relative to the
+            location of the manifest. The id is the path without suffix,
+            unless being specified explicitly: "id=path"
+         */
+
+        QFile file( path );
+        if ( !file.open( QIODevice::ReadOnly | QIODevice::Text ) )
+        {
+            qWarning() << "can't open" << path;
+            return sources;
+        }
+
+        const auto dir = fileInfo.absoluteDir();
+
+        QTextStream stream( &file );
+        while ( !stream.atEnd() )
+        {
+            const auto line = stream.readLine().trimmed();
+            if ( line.isEmpty() || line.startsWith( QLatin1Char( '#' ) ) )
+                continue;
+
+            const int pos = line.indexOf( QLatin1Char( '=' ) );
+            if ( pos >= 0 )
+            {
+                const auto svgFile = line.mid( pos + 1 ).trimmed();
+                sources.insert( line.left( pos ).trimmed(), dir.filePath( svgFile ) );
+            }
+            else
+            {
+                sources.insert( graphicId( line ), dir.filePath( line ) );
+            }
+        }
+    }
+
+    return sources;
+}
+
+static int compileArchive( const QString& source,
+    const QString& archiveFile, int jobs, bool optimize, bool verbose )
+{
+    const auto sources = svgSources( source );
+    if ( sources.isEmpty() )
+    {
+        qWarning() << "no SVG files found:" << source;
+        return -2;
+    }
+
+    const auto ids = sources.keys();
+
+    QVector< QByteArray > qvgData( ids.size() );
+    QAtomicInt failures;
+    QAtomicInt numCommands;
+    QAtomicInt numOptimized;
+
+    {
+        QThreadPool pool;
+        if ( jobs > 0 )
+            pool.setMaxThreadCount( jobs );
+
+        for ( int i = 0; i < ids.size(); i++ )
+        {
+            const auto svgFile = sources[ ids[ i ] ];
+            auto data = qvgData.data() + i;
+
+            pool.start( [ svgFile, data, optimize,
+                &failures, &numCommands, &numOptimized ]()
+            {
+                QskGraphic graphic;
+
+                if ( loadSvg( svgFile, graphic ) )
+                {
+                    int count = graphic.commands().size();
+                    numCommands.fetchAndAddRelaxed( count );
+
+                    if ( optimize )
+                        graphic = optimizedGraphic( graphic, count );
+
+                    numOptimized.fetchAndAddRelaxed( count );
+
+                    QskGraphicIO::write( graphic, *data );
+                }
+                else
+                {
+                    qWarning() << "can't load" << svgFile;
+                    failures.ref();
+                }
+            } );
+        }
+
+        pool.waitForDone();
+    }
+
+    if ( failures.loadRelaxed() > 0 )
+        return -2;
+
+    if ( optimize && verbose )
+    {
+        printStatistics( archiveFile,
+            numCommands.loadRelaxed(), numOptimized.loadRelaxed() );
+    }
+
+    QMap< QString, QByteArray > graphics;
+    for ( int i = 0; i < ids.size(); i++ )
+        graphics.insert( ids[ i ], qvgData[ i ] );
+
+    return QskGraphicArchive::write( graphics, archiveFile ) ? 0 : -3;
 }
 
 int main( int argc, char* argv[] )
 {
-    if ( argc != 3 )
+    QString archiveFile;
+    int jobs = 0;
+    bool optimize = true;
+    bool verbose = false;
+
+    QStringList args;
+
+    for ( int i = 1; i < argc; i++ )
+    {
+        const auto arg = QString::fromLocal8Bit( argv[i] );
+
+        if ( ( arg == QStringLiteral( "-a" ) ) && ( i + 1 < argc ) )
+            archiveFile = QString::fromLocal8Bit( argv[++i] );
+        else if ( ( arg == QStringLiteral( "-j" ) ) && ( i + 1 < argc ) )
+            jobs = QString::fromLocal8Bit( argv[++i] ).toInt();
+        else if ( arg == QStringLiteral( "-O0" ) )
+            optimize = false;
+        else if ( arg == QStringLiteral( "-v" ) )
+            verbose = true;
+        else
+            args += arg;
+    }
+
+    if ( archiveFile.isEmpty() ? ( args.size() != 2 ) : ( args.size() != 1 ) )
     {
         usage( argv[0] );
         return -1;
@@ -51,21 +300,36 @@ int main( int argc, char* argv[] )
     QGuiApplication app( argc, argv );
 #endif
 
-    QSvgRenderer renderer;
-    if ( !renderer.load( QString( argv[1] ) ) )
-        return -2;
+    if ( !archiveFile.isEmpty() )
+    {
+        /*
+            Converting all SVGs in parallel and writing them into
+            one indexed archive, that can be used by QskGraphicArchiveProvider
+         */
+        return compileArchive( args[0], archiveFile, jobs, optimize, verbose );
+    }
 
     QskGraphic graphic;
+    if ( !loadSvg( args[0], graphic ) )
+        return -2;
 
-    QPainter painter( &graphic );
-    renderer.render( &painter );
-    painter.end();
+    if ( optimize )
+    {
+        int numOptimized = 0;
+        const int numCommands = graphic.commands().size();
 
-    if ( graphic.commandTypes() & QskGraphic::RasterData )
-        qWarning() << argv[1] << "contains non scalable parts.";
+        const auto optimized = optimizedGraphic( graphic, numOptimized );
+
+        if ( verbose )
+        {
+            printStatistics( args[0], numCommands, numOptimized );
+            printRenderTimes( args[0], graphic, optimized );
+        }
 
-    QskGraphicIO::write( graphic, argv[2] );
+        graphic = optimized;
+    }
+
+    QskGraphicIO::write( graphic, args[1] );
 
     return 0;
 }
-